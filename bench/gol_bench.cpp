@@ -0,0 +1,556 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "workloads.h"
+#include "perf_counters.h"
+#include "simulation/engine_registry.h"
+#include "simulation/batch_engine.h"
+#include "simulation/lenia_engine.h"
+
+namespace {
+
+struct Options {
+    std::vector<std::string> engines;
+    std::vector<std::string> workloads;
+    Rule rule = ConwayRule;
+    Topology topology = Topology::Bounded;
+    int generations = 0;
+    double maxSeconds = 20;
+    bool micro = false;
+    bool lenia = false;
+    bool batch = false;
+    bool list = false;
+};
+
+struct Result {
+    std::string engine;
+    const Workload* workload;
+    int generations;
+    // stopped by the time budget before reaching the generations of the workload
+    bool truncated;
+    double seconds;
+    // live cells, or the rounded mass of Lenia boards
+    std::uint64_t population;
+    std::uint64_t peakRssBytes;
+};
+
+// a board that stays in L1/L2 and one well beyond any last level cache
+struct MicroSize {
+    const char* name;
+    int width;
+    int height;
+};
+
+const MicroSize microSizes[] = {
+        {"in-cache", 256, 256},
+        {"out-of-cache", 16384, 16384},
+};
+
+// counters are read over this much stepping, at least one step
+const double microSeconds = .5;
+
+// generations per Engine::Advance call, a few passes of the temporal blocking engine
+const int advanceGenerations = 16;
+
+// Lenia runs on the soups up to this size unless a larger one is asked for by name
+const int leniaMaxExtent = 4096;
+
+// board sizes of the batch mode, all soups, as many boards as one transposed batch of four
+// words a cell holds
+const int batchSizes[] = {32, 64, 128, 256};
+const int batchBoardCount = 256;
+// cell updates per run unless the generations are given
+const double batchCellUpdates = 1 << 30;
+
+struct BatchResult {
+    std::string engine;
+    int size;
+    int generations;
+    bool truncated;
+    double seconds;
+    // live cells over all boards
+    std::uint64_t population;
+};
+
+struct MicroResult {
+    std::string engine;
+    const MicroSize* size;
+    int iterations;
+    double seconds;
+    PerfSample sample;
+    const char* source;
+    const char* scope;
+};
+
+void printUsage() {
+    std::cerr << "usage: gol_bench [--engine NAME]... [--workload NAME]... [--rule B3/S23] [--topology bounded|torus|klein]\n"
+                 "                 [--generations N] [--max-seconds S] [--micro] [--lenia] [--batch] [--list]\n"
+                 "Runs every engine on every standard workload and prints the results as JSON.\n"
+                 "A run stops early after S seconds (default 20) so slow engines do not stall the suite.\n"
+                 "--micro times a single step kernel on an in-cache and an out-of-cache soup instead and\n"
+                 "reports cycles, instructions, cache and branch misses per cell.\n"
+                 "--lenia runs the Lenia engine (Orbium) on the soup workloads instead of the rule.\n"
+                 "--batch steps 256 small soups at once in a transposed batch and one at a time with the\n"
+                 "bitwise engine." << std::endl;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (argument == "--engine" && hasValue) {
+            options.engines.emplace_back(argv[++i]);
+        } else if (argument == "--workload" && hasValue) {
+            options.workloads.emplace_back(argv[++i]);
+        } else if (argument == "--rule" && hasValue) {
+            if (!ParseRule(argv[++i], options.rule)) {
+                std::cerr << "Invalid rule " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (argument == "--topology" && hasValue) {
+            if (!ParseTopology(argv[++i], options.topology)) {
+                std::cerr << "Invalid topology " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (argument == "--generations" && hasValue) {
+            options.generations = std::atoi(argv[++i]);
+        } else if (argument == "--max-seconds" && hasValue) {
+            options.maxSeconds = std::atof(argv[++i]);
+        } else if (argument == "--micro") {
+            options.micro = true;
+        } else if (argument == "--lenia") {
+            options.lenia = true;
+        } else if (argument == "--batch") {
+            options.batch = true;
+        } else if (argument == "--list") {
+            options.list = true;
+        } else {
+            printUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool contains(const std::vector<std::string>& names, const std::string& name) {
+    return names.empty() || std::find(names.begin(), names.end(), name) != names.end();
+}
+
+// the high water mark is per process, so it is reset before every run where the OS allows it
+void resetPeakRss() {
+#if defined(__linux__)
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+#endif
+}
+
+std::uint64_t getPeakRss() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+#if defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return std::strtoull(line.c_str() + 6, nullptr, 10) * 1024;
+        }
+    }
+#endif
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return static_cast<std::uint64_t>(usage.ru_maxrss);
+#else
+    return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+Result run(const std::string& engineName, const Rule& rule, Topology topology, const Workload& workload,
+           const Board& initial, int generations, double maxSeconds) {
+    auto engine = CreateEngine(engineName, rule);
+    resetPeakRss();
+
+    // Generations rules keep the dying states in extra planes
+    Board current = initial;
+    current.SetPlaneCount(GetStatePlaneCount(rule));
+    current.SetTopology(topology);
+    current.RefreshHalo();
+    Board next(initial.GetWidth(), initial.GetHeight(), current.GetPlaneCount());
+    next.SetTopology(topology);
+
+    auto start = std::chrono::steady_clock::now();
+    double seconds = 0;
+    int generation = 0;
+    while (generation < generations && seconds < maxSeconds) {
+        // a few generations per call, for the engines that step several per pass over the board
+        int count = std::min(advanceGenerations, generations - generation);
+        engine->Advance(current, next, count);
+        generation += count;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    return Result{engineName, &workload, generation, generation < generations, seconds, current.GetPopulation(),
+                  getPeakRss()};
+}
+
+// the cells the soup would make alive start with uniformly random states
+Result runLenia(const LeniaRule& rule, const Workload& workload, int generations, double maxSeconds) {
+    LeniaEngine engine(rule);
+    resetPeakRss();
+
+    ContinuousBoard current(workload.width, workload.height);
+    current.Randomize(workload.seed, workload.density);
+    ContinuousBoard next(workload.width, workload.height);
+
+    auto start = std::chrono::steady_clock::now();
+    double seconds = 0;
+    int generation = 0;
+    while (generation < generations && seconds < maxSeconds) {
+        engine.Step(current, next);
+        std::swap(current, next);
+        generation++;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    return Result{"lenia", &workload, generation, generation < generations, seconds,
+                  static_cast<std::uint64_t>(current.GetMass() + .5), getPeakRss()};
+}
+
+// the same soups stepped together in a batch, or one after the other with the bitwise engine
+BatchResult runBatch(bool transposed, const Rule& rule, Topology topology, int size, int generations,
+                     double maxSeconds) {
+    BoardBatch current(size, size, batchBoardCount);
+    current.Randomize(static_cast<std::uint64_t>(size), .5f);
+    current.SetTopology(topology);
+    current.RefreshHalo();
+
+    auto start = std::chrono::steady_clock::now();
+    double seconds = 0;
+    int generation = 0;
+    std::uint64_t population = 0;
+    if (transposed) {
+        BatchEngine engine(rule);
+        BoardBatch next(size, size, batchBoardCount);
+        next.SetTopology(topology);
+        while (generation < generations && seconds < maxSeconds) {
+            engine.Step(current, next);
+            std::swap(current, next);
+            generation++;
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        for (std::uint64_t boardPopulation : current.GetPopulations()) {
+            population += boardPopulation;
+        }
+    } else {
+        // each board runs all of its generations while it is in cache, the time budget is
+        // checked once per board and scaled to the generations of all boards
+        std::vector<Board> boards;
+        for (int board = 0; board < batchBoardCount; board++) {
+            boards.push_back(current.GetBoard(board));
+        }
+        start = std::chrono::steady_clock::now();
+        auto engine = CreateEngine("bitwise", rule);
+        Board next(size, size);
+        next.SetTopology(topology);
+        int stepped = 0;
+        for (Board& board : boards) {
+            if (seconds >= maxSeconds) {
+                break;
+            }
+            for (int i = 0; i < generations; i++) {
+                engine->Step(board, next);
+                std::swap(board, next);
+            }
+            population += board.GetPopulation();
+            stepped++;
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        generation = static_cast<int>(static_cast<std::int64_t>(generations) * stepped / batchBoardCount);
+    }
+
+    return BatchResult{transposed ? "batch" : "bitwise", size, generation, generation < generations, seconds,
+                       population};
+}
+
+void printBatchResults(const Rule& rule, Topology topology, const std::vector<BatchResult>& results) {
+    std::ostringstream json;
+    json << "{\n";
+#if !defined(NDEBUG)
+    json << "  \"warning\": \"built without NDEBUG, configure with -DCMAKE_BUILD_TYPE=Release\",\n";
+#endif
+    json << "  \"rule\": \"" << FormatRule(rule) << "\",\n";
+    json << "  \"topology\": \"" << GetTopologyName(topology) << "\",\n";
+    json << "  \"boards\": " << batchBoardCount << ",\n";
+    json << "  \"batch\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BatchResult& result = results[i];
+        double boardGenerations = static_cast<double>(result.generations) * batchBoardCount;
+        double cells = boardGenerations * result.size * result.size;
+        json << (i == 0 ? "\n" : ",\n")
+             << "    {\"engine\": \"" << result.engine << "\""
+             << ", \"width\": " << result.size
+             << ", \"height\": " << result.size
+             << ", \"generations\": " << result.generations
+             << ", \"truncated\": " << (result.truncated ? "true" : "false")
+             << ", \"seconds\": " << result.seconds
+             << ", \"boardGenerationsPerSecond\": " << (result.seconds > 0 ? boardGenerations / result.seconds : 0)
+             << ", \"cellsPerNs\": " << (result.seconds > 0 ? cells / (result.seconds * 1e9) : 0)
+             << ", \"population\": " << result.population << "}";
+    }
+    json << "\n  ]\n}\n";
+    std::cout << json.str();
+}
+
+MicroResult runMicro(const std::string& engineName, const Rule& rule, Topology topology, const MicroSize& size) {
+    // opened before the engine starts its thread pool, whose workers then count as well
+    PerfCounters counters;
+    auto engine = CreateEngine(engineName, rule);
+    Board current(size.width, size.height, GetStatePlaneCount(rule));
+    current.Randomize(size.width, .5f);
+    current.SetTopology(topology);
+    current.RefreshHalo();
+    Board next(size.width, size.height, current.GetPlaneCount());
+    next.SetTopology(topology);
+
+    // always the same input so the kernel sees a 50% soup on every iteration, the first
+    // step warms the caches and sizes the measured loop
+    auto start = std::chrono::steady_clock::now();
+    engine->Step(current, next);
+    double stepSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    int iterations = std::max(1, static_cast<int>(microSeconds / std::max(stepSeconds, 1e-9)));
+
+    start = std::chrono::steady_clock::now();
+    counters.Start();
+    for (int i = 0; i < iterations; i++) {
+        engine->Step(current, next);
+    }
+    PerfSample sample = counters.Stop();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return MicroResult{engineName, &size, iterations, seconds, sample, counters.GetSource(), counters.GetScope()};
+}
+
+void printMicroResults(const Rule& rule, Topology topology, const std::vector<MicroResult>& results) {
+    std::ostringstream json;
+    json << "{\n";
+#if !defined(NDEBUG)
+    json << "  \"warning\": \"built without NDEBUG, configure with -DCMAKE_BUILD_TYPE=Release\",\n";
+#endif
+    json << "  \"rule\": \"" << FormatRule(rule) << "\",\n";
+    json << "  \"topology\": \"" << GetTopologyName(topology) << "\",\n";
+    json << "  \"micro\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const MicroResult& result = results[i];
+        double cells = static_cast<double>(result.size->width) * result.size->height * result.iterations;
+        auto perCell = [&result, cells](PerfCounter counter) {
+            int index = static_cast<int>(counter);
+            std::ostringstream value;
+            if (result.sample.available[index]) {
+                value << static_cast<double>(result.sample.values[index]) / cells;
+            } else {
+                value << "null";
+            }
+            return value.str();
+        };
+
+        json << (i == 0 ? "\n" : ",\n")
+             << "    {\"engine\": \"" << result.engine << "\""
+             << ", \"size\": \"" << result.size->name << "\""
+             << ", \"width\": " << result.size->width
+             << ", \"height\": " << result.size->height
+             << ", \"iterations\": " << result.iterations
+             << ", \"counterSource\": \"" << result.source << "\""
+             << ", \"counterScope\": \"" << result.scope << "\""
+             << ", \"nsPerCell\": " << result.seconds * 1e9 / cells;
+        for (int counter = 0; counter < static_cast<int>(PerfCounter::Count); counter++) {
+            json << ", \"" << GetPerfCounterName(static_cast<PerfCounter>(counter)) << "PerCell\": "
+                 << perCell(static_cast<PerfCounter>(counter));
+        }
+
+        const PerfSample& sample = result.sample;
+        int cycles = static_cast<int>(PerfCounter::Cycles);
+        int instructions = static_cast<int>(PerfCounter::Instructions);
+        json << ", \"ipc\": ";
+        if (sample.available[cycles] && sample.available[instructions] && sample.values[cycles] > 0) {
+            json << static_cast<double>(sample.values[instructions]) / static_cast<double>(sample.values[cycles]);
+        } else {
+            json << "null";
+        }
+        json << "}";
+    }
+    json << "\n  ]\n}\n";
+    std::cout << json.str();
+}
+
+void printResults(const std::string& rule, Topology topology, const std::vector<Result>& results) {
+    std::ostringstream json;
+    json << "{\n";
+#if !defined(NDEBUG)
+    json << "  \"warning\": \"built without NDEBUG, configure with -DCMAKE_BUILD_TYPE=Release\",\n";
+#endif
+    json << "  \"rule\": \"" << rule << "\",\n";
+    json << "  \"topology\": \"" << GetTopologyName(topology) << "\",\n";
+    json << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& result = results[i];
+        double cells = static_cast<double>(result.workload->width) * result.workload->height * result.generations;
+        json << (i == 0 ? "\n" : ",\n")
+             << "    {\"engine\": \"" << result.engine << "\""
+             << ", \"workload\": \"" << result.workload->name << "\""
+             << ", \"width\": " << result.workload->width
+             << ", \"height\": " << result.workload->height
+             << ", \"generations\": " << result.generations
+             << ", \"truncated\": " << (result.truncated ? "true" : "false")
+             << ", \"seconds\": " << result.seconds
+             << ", \"generationsPerSecond\": " << (result.seconds > 0 ? result.generations / result.seconds : 0)
+             << ", \"cellsPerNs\": " << (result.seconds > 0 ? cells / (result.seconds * 1e9) : 0)
+             << ", \"population\": " << result.population
+             << ", \"peakRssBytes\": " << result.peakRssBytes << "}";
+    }
+    json << "\n  ]\n}\n";
+    std::cout << json.str();
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    std::vector<std::string> engines = GetEngineNames();
+    std::vector<Workload> workloads = GetStandardWorkloads();
+
+    if (options.list) {
+        std::cout << "engines:";
+        for (const auto& engine : engines) {
+            std::cout << " " << engine;
+        }
+        std::cout << "\nworkloads:";
+        for (const auto& workload : workloads) {
+            std::cout << " " << workload.name;
+        }
+        std::cout << std::endl;
+        return 0;
+    }
+
+    if (options.lenia) {
+        LeniaRule rule;
+        std::vector<Result> results;
+        for (const Workload& workload : workloads) {
+            bool named = !options.workloads.empty() && contains(options.workloads, workload.name);
+            bool small = options.workloads.empty() && workload.width <= leniaMaxExtent
+                         && workload.height <= leniaMaxExtent;
+            if (workload.rle != nullptr || !(named || small)) {
+                continue;
+            }
+
+            int generations = options.generations > 0 ? options.generations : workload.generations;
+            std::cerr << workload.name << " / lenia..." << std::endl;
+            results.push_back(runLenia(rule, workload, generations, options.maxSeconds));
+        }
+        // the Lenia engine pads its boards, they are always bounded
+        printResults(FormatLeniaRule(rule), Topology::Bounded, results);
+        return 0;
+    }
+
+    if (options.batch) {
+        if (!BatchEngine::Supports(options.rule)) {
+            std::cerr << "The batch engine does not run " << FormatRule(options.rule) << std::endl;
+            return 1;
+        }
+
+        std::vector<BatchResult> results;
+        for (int size : batchSizes) {
+            int generations = options.generations > 0
+                              ? options.generations
+                              : static_cast<int>(batchCellUpdates / (static_cast<double>(size) * size * batchBoardCount));
+            for (bool transposed : {true, false}) {
+                std::cerr << size << "x" << size << " / " << (transposed ? "batch" : "bitwise") << "..." << std::endl;
+                results.push_back(runBatch(transposed, options.rule, options.topology, size, generations,
+                                           options.maxSeconds));
+            }
+        }
+        printBatchResults(options.rule, options.topology, results);
+        return 0;
+    }
+
+    for (const auto& name : options.engines) {
+        if (std::find(engines.begin(), engines.end(), name) == engines.end()) {
+            std::cerr << "Unknown engine " << name << std::endl;
+            return 1;
+        }
+    }
+
+    // not every engine runs Generations rules
+    engines.erase(std::remove_if(engines.begin(), engines.end(), [&options](const std::string& name) {
+        bool supported = CreateEngine(name, options.rule) != nullptr;
+        if (!supported && contains(options.engines, name)) {
+            std::cerr << "Skipping " << name << ", it does not run " << FormatRule(options.rule) << std::endl;
+        }
+        return !supported;
+    }), engines.end());
+
+    if (options.micro) {
+        std::vector<MicroResult> results;
+        for (const MicroSize& size : microSizes) {
+            for (const auto& engine : engines) {
+                if (contains(options.engines, engine)) {
+                    std::cerr << size.name << " / " << engine << "..." << std::endl;
+                    results.push_back(runMicro(engine, options.rule, options.topology, size));
+                }
+            }
+        }
+        printMicroResults(options.rule, options.topology, results);
+        return 0;
+    }
+
+    std::vector<Result> results;
+    for (const Workload& workload : workloads) {
+        if (!contains(options.workloads, workload.name)) {
+            continue;
+        }
+
+        Board initial;
+        if (!SetUpWorkload(workload, initial)) {
+            return 1;
+        }
+
+        int generations = options.generations > 0 ? options.generations : workload.generations;
+        for (const auto& engine : engines) {
+            if (!contains(options.engines, engine)) {
+                continue;
+            }
+
+            std::cerr << workload.name << " / " << engine << "..." << std::endl;
+            results.push_back(run(engine, options.rule, options.topology, workload, initial, generations,
+                                  options.maxSeconds));
+        }
+    }
+
+    printResults(FormatRule(options.rule), options.topology, results);
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include "perf_counters.h"
+
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define GOL_HAS_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define GOL_HAS_RDTSC 1
+#endif
+
+namespace {
+
+const int counterCount = static_cast<int>(PerfCounter::Count);
+
+#if defined(__linux__)
+int openCounter(std::uint32_t type, std::uint64_t config) {
+    perf_event_attr attributes;
+    std::memset(&attributes, 0, sizeof(attributes));
+    attributes.size = sizeof(attributes);
+    attributes.type = type;
+    attributes.config = config;
+    attributes.disabled = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    // threads started later count too, the pools of the engines, and reads sum them; the ioctls
+    // reach their counters as well
+    attributes.inherit = 1;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+}
+
+std::uint64_t cacheConfig(std::uint64_t cache, std::uint64_t operation, std::uint64_t result) {
+    return cache | (operation << 8) | (result << 16);
+}
+#endif
+
+}
+
+const char* GetPerfCounterName(PerfCounter counter) {
+    switch (counter) {
+        case PerfCounter::Cycles: return "cycles";
+        case PerfCounter::Instructions: return "instructions";
+        case PerfCounter::L1DataMisses: return "l1dMisses";
+        case PerfCounter::LastLevelCacheMisses: return "llcMisses";
+        case PerfCounter::BranchMisses: return "branchMisses";
+        default: return "";
+    }
+}
+
+PerfCounters::PerfCounters() : m_descriptors(), m_perf(false), m_startTicks(0) {
+    for (int& descriptor : m_descriptors) {
+        descriptor = -1;
+    }
+
+#if defined(__linux__)
+    m_descriptors[static_cast<int>(PerfCounter::Cycles)] =
+            openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    m_descriptors[static_cast<int>(PerfCounter::Instructions)] =
+            openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    m_descriptors[static_cast<int>(PerfCounter::L1DataMisses)] =
+            openCounter(PERF_TYPE_HW_CACHE, cacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                                                        PERF_COUNT_HW_CACHE_RESULT_MISS));
+    m_descriptors[static_cast<int>(PerfCounter::LastLevelCacheMisses)] =
+            openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    m_descriptors[static_cast<int>(PerfCounter::BranchMisses)] =
+            openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    m_perf = m_descriptors[static_cast<int>(PerfCounter::Cycles)] >= 0;
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#if defined(__linux__)
+    for (int descriptor : m_descriptors) {
+        if (descriptor >= 0) {
+            close(descriptor);
+        }
+    }
+#endif
+}
+
+void PerfCounters::Start() {
+#if defined(__linux__)
+    for (int descriptor : m_descriptors) {
+        if (descriptor >= 0) {
+            ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+            ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+#if defined(GOL_HAS_RDTSC)
+    m_startTicks = __rdtsc();
+#endif
+}
+
+PerfSample PerfCounters::Stop() {
+    PerfSample sample;
+#if defined(GOL_HAS_RDTSC)
+    std::uint64_t ticks = __rdtsc() - m_startTicks;
+    sample.values[static_cast<int>(PerfCounter::Cycles)] = ticks;
+    sample.available[static_cast<int>(PerfCounter::Cycles)] = true;
+#endif
+
+#if defined(__linux__)
+    for (int i = 0; i < counterCount; i++) {
+        if (m_descriptors[i] < 0) {
+            continue;
+        }
+
+        ioctl(m_descriptors[i], PERF_EVENT_IOC_DISABLE, 0);
+        std::uint64_t value = 0;
+        if (read(m_descriptors[i], &value, sizeof(value)) == sizeof(value)) {
+            sample.values[i] = value;
+            sample.available[i] = true;
+        }
+    }
+#endif
+    return sample;
+}
+
+const char* PerfCounters::GetScope() const {
+    if (m_perf) {
+        return "threads";
+    }
+#if defined(GOL_HAS_RDTSC)
+    return "wall";
+#else
+    return "none";
+#endif
+}
+
+const char* PerfCounters::GetSource() const {
+    if (m_perf) {
+        return "perf";
+    }
+#if defined(GOL_HAS_RDTSC)
+    return "rdtsc";
+#else
+    return "none";
+#endif
+}
@@ -0,0 +1,50 @@
+#ifndef GAME_OF_LIFE_PERF_COUNTERS_H
+#define GAME_OF_LIFE_PERF_COUNTERS_H
+
+#include <cstdint>
+
+enum class PerfCounter {
+    Cycles,
+    Instructions,
+    L1DataMisses,
+    LastLevelCacheMisses,
+    BranchMisses,
+    Count
+};
+
+const char* GetPerfCounterName(PerfCounter counter);
+
+struct PerfSample {
+    std::uint64_t values[static_cast<int>(PerfCounter::Count)] = {};
+    bool available[static_cast<int>(PerfCounter::Count)] = {};
+};
+
+// Hardware counters through perf_event_open of the calling thread and of every thread it starts
+// after the counters are constructed, summed, so construct them before the engine whose thread
+// pool is measured. Where perf is not available (other systems, perf_event_paranoid, virtual
+// machines) only cycles are counted, from the time stamp counter, which ticks at a constant rate
+// rather than the core clock and counts wall time however many threads run.
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    void Start();
+    PerfSample Stop();
+
+    // "perf" or "rdtsc" or "none"
+    const char* GetSource() const;
+    // "threads" when the counts are summed over the threads, "wall" for the time stamp counter
+    // or "none"
+    const char* GetScope() const;
+
+private:
+    int m_descriptors[static_cast<int>(PerfCounter::Count)];
+    bool m_perf;
+    std::uint64_t m_startTicks;
+};
+
+#endif //GAME_OF_LIFE_PERF_COUNTERS_H
@@ -0,0 +1,50 @@
+#include <iostream>
+
+#include "workloads.h"
+#include "simulation/rle.h"
+
+namespace {
+
+const char* rPentomino = "x = 3, y = 3, rule = B3/S23\n"
+                         "b2o$2o$bo!\n";
+
+const char* gosperGliderGun = "x = 36, y = 9, rule = B3/S23\n"
+                              "24bo$22bobo$12b2o6b2o12b2o$11bo3bo4b2o12b2o$2o8bo5bo3b2o$2o8bo3bob2o4bobo$"
+                              "10bo5bo7bo$11bo3bo$12b2o!\n";
+
+const char* acorn = "x = 7, y = 3, rule = B3/S23\n"
+                    "bo$3bo$2o2b3o!\n";
+
+// smallest known pattern with unbounded growth, a block-laying switch engine
+const char* switchEngine = "x = 8, y = 6, rule = B3/S23\n"
+                           "6bo$4bob2o$4bobo$4bo$2bo$obo!\n";
+
+}
+
+std::vector<Workload> GetStandardWorkloads() {
+    return {
+            {"r-pentomino", 1024, 1024, 1103, rPentomino, 0, 0},
+            {"gosper-gun", 1024, 1024, 2000, gosperGliderGun, 0, 0},
+            {"acorn", 2048, 2048, 5206, acorn, 0, 0},
+            {"switch-engine", 2048, 2048, 4000, switchEngine, 0, 0},
+            {"soup-1k", 1024, 1024, 1000, nullptr, .5f, 1},
+            {"soup-4k", 4096, 4096, 100, nullptr, .5f, 4},
+            {"soup-16k", 16384, 16384, 10, nullptr, .5f, 16},
+    };
+}
+
+bool SetUpWorkload(const Workload& workload, Board& board) {
+    board = Board(workload.width, workload.height);
+    if (workload.rle == nullptr) {
+        board.Randomize(workload.seed, workload.density);
+        return true;
+    }
+
+    Pattern pattern;
+    if (!ParseRle(workload.rle, pattern)) {
+        std::cerr << "Failed to parse the pattern of " << workload.name << std::endl;
+        return false;
+    }
+    PlacePatternCentered(pattern, board);
+    return true;
+}
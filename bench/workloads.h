@@ -0,0 +1,26 @@
+#ifndef GAME_OF_LIFE_WORKLOADS_H
+#define GAME_OF_LIFE_WORKLOADS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "simulation/board.h"
+
+// A board to benchmark: either a pattern in the middle of an empty field or a random soup.
+struct Workload {
+    std::string name;
+    int width;
+    int height;
+    int generations;
+    // run length encoded pattern, nullptr for a soup
+    const char* rle;
+    float density;
+    std::uint64_t seed;
+};
+
+std::vector<Workload> GetStandardWorkloads();
+
+bool SetUpWorkload(const Workload& workload, Board& board);
+
+#endif //GAME_OF_LIFE_WORKLOADS_H
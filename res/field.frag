@@ -0,0 +1,17 @@
+#version 330 core
+in vec2 fieldPosition;
+out vec4 color;
+
+// states of a continuous board in [0, 1], in the red channel
+uniform sampler2D field;
+
+void main()
+{
+    // dark blue through orange to pale yellow, empty cells blend into the background
+    float state = clamp(texture(field, fieldPosition).r, 0.0, 1.0);
+    vec3 low = vec3(0.1, 0.1, 0.35);
+    vec3 mid = vec3(0.9, 0.45, 0.15);
+    vec3 high = vec3(1.0, 0.95, 0.7);
+    vec3 rgb = state < 0.5 ? mix(low, mid, state * 2.0) : mix(mid, high, state * 2.0 - 1.0);
+    color = vec4(rgb, state < 0.01 ? 0.0 : 1.0);
+}
@@ -0,0 +1,13 @@
+#version 330 core
+layout (location = 0) in vec2 position;
+layout (location = 1) in vec2 uv;
+
+uniform mat4 screenTransform;
+
+out vec2 fieldPosition;
+
+void main()
+{
+    gl_Position = screenTransform * vec4(position.xy, 0, 1f);
+    fieldPosition = uv;
+}
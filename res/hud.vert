@@ -0,0 +1,13 @@
+#version 330 core
+layout (location = 0) in vec2 position;
+layout (location = 1) in vec4 color;
+
+uniform mat4 projection;
+
+out vec4 vertex_color;
+
+void main()
+{
+    gl_Position = projection * vec4(position.xy, 0, 1.0);
+    vertex_color = color;
+}
@@ -1,9 +1,11 @@
 #version 330 core
+flat in uint cellState;
 out vec4 color;
 
-uniform vec4 quad_color;
+// colour of every cell state, 1 is alive and 2 and up the dying states of Generations rules
+uniform sampler1D palette;
 
 void main()
 {
-    color = quad_color;
+    color = texelFetch(palette, int(cellState), 0);
 }
\ No newline at end of file
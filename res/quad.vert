@@ -1,9 +1,13 @@
 #version 330 core
 layout (location = 0) in vec2 position;
+layout (location = 1) in uint state;
 
 uniform mat4 screenTransform;
 
+flat out uint cellState;
+
 void main()
 {
     gl_Position = screenTransform * vec4(position.xy, 0, 1f);
+    cellState = state;
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <algorithm>
+#include <random>
 #include <vector>
 
 #include <glad/glad.h>
@@ -10,6 +11,19 @@
 #include "graphics/renderer.h"
 #include "graphics/screen_settings.h"
 #include "graphics/camera.h"
+#include "graphics/frame_stats.h"
+#include "graphics/gpu_timer.h"
+#include "graphics/hud.h"
+#include "graphics/field_renderer.h"
+#include "profiling/trace.h"
+#include "simulation/bits.h"
+#include "simulation/bitwise_engine.h"
+#include "simulation/checkpoint.h"
+#include "simulation/cycle_detector.h"
+#include "simulation/history.h"
+#include "simulation/larger_than_life_engine.h"
+#include "simulation/lenia_engine.h"
+#include "simulation/universe.h"
 
 #include <glm/gtx/string_cast.hpp>
 
@@ -37,13 +51,129 @@ float sizeStep = 1;
 float maxSize = 8;
 float minSize = 1;
 
+const std::uint64_t checkpointInterval = 1000;
+bool checkpoints_enabled = false;
+bool checkpoints_changed = false;
+
+const size_t historyBudget = 64 * 1024 * 1024;
+bool paused = false;
+int step_requests = 0;
+int rewind_requests = 0;
+
+// the F key jumps this far ahead once the whole plane repeats
+const size_t cycleWindow = 1 << 16;
+const std::uint64_t fastForwardGenerations = 1000000;
+bool fast_forward_requested = false;
+
+bool show_hud = false;
+
+bool tracing_requested = false;
+
+// rules the R key cycles through
+const Rule rules[] = {ConwayRule, HighLifeRule, DayAndNightRule, BriansBrainRule, StarWarsRule, BoscosRule};
+int rule_index = 0;
+bool rule_changed = false;
+
+// the L key swaps the board for a continuous one stepped by Lenia
+bool lenia_mode = false;
+bool lenia_changed = false;
+
 void updateProjection(const ResourceManager& resourceManager) {
     auto shader = resourceManager.GetShader("quad");
     shader->SetMatrix4("screenTransform", camera.GetProjectionMatrix(), true);
+    resourceManager.GetShader("field")->SetMatrix4("screenTransform", camera.GetProjectionMatrix(), true);
 
     std::cout << glm::to_string(camera.GetProjectionMatrix()) << std::endl;
 }
 
+// points of the cells of a chunk that are not dead, cell (0, 0) at origin and step apart, and the
+// state of every point for multi-state boards
+void buildPoints(std::vector<float>& points, std::vector<std::uint8_t>& states, const Board& board,
+                 glm::vec2 origin, float step) {
+    int planeCount = board.GetPlaneCount();
+
+    for (int j = 0; j < board.GetHeight(); j++)
+    {
+        for (int w = 0; w < board.GetWordsPerRow(); w++)
+        {
+            // walk the cells that are set in any plane only, the halo bits are always clear
+            std::uint64_t word = 0;
+            for (int plane = 0; plane < planeCount; plane++)
+            {
+                word |= board.GetRow(j, plane)[w];
+            }
+            while (word != 0)
+            {
+                int bit = CountTrailingZeros(word);
+                int i = w * 64 + bit - 1;
+                word &= word - 1;
+
+                points.emplace_back(origin.x + step * i);
+                points.emplace_back(origin.y + step * j);
+                if (planeCount > 1)
+                {
+                    std::uint8_t state = 0;
+                    for (int plane = 0; plane < planeCount; plane++)
+                    {
+                        state |= static_cast<std::uint8_t>(((board.GetRow(j, plane)[w] >> bit) & 1) << plane);
+                    }
+                    states.push_back(state);
+                }
+            }
+        }
+    }
+}
+
+// colour of every cell state: live cells grey, dying cells fading from orange to dark red
+void updatePalette(unsigned int texture, const Rule& rule) {
+    std::vector<glm::vec4> palette(MaxRuleStates, glm::vec4(0.f));
+    palette[1] = glm::vec4(0.8f, 0.8f, 0.8f, 1.f);
+    for (int state = 2; state < rule.states; state++) {
+        float age = rule.states > 3 ? static_cast<float>(state - 2) / static_cast<float>(rule.states - 3) : 0.f;
+        palette[state] = glm::mix(glm::vec4(1.f, 0.6f, 0.2f, 1.f), glm::vec4(0.4f, 0.05f, 0.05f, 1.f), age);
+    }
+
+    glBindTexture(GL_TEXTURE_1D, texture);
+    glTexImage1D(GL_TEXTURE_1D, 0, GL_RGBA, MaxRuleStates, 0, GL_RGBA, GL_FLOAT, palette.data());
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_1D, 0);
+}
+
+// Larger-than-Life rules need the engine that counts the wider box
+std::unique_ptr<Engine> createEngine(const Rule& rule) {
+    if (rule.radius > 1) {
+        return std::make_unique<LargerThanLifeEngine>(rule);
+    }
+    return std::make_unique<BitwiseEngine>(rule);
+}
+
+// cell (0, 0) of the plane at the world origin
+void buildPoints(std::vector<float>& points, std::vector<std::uint8_t>& states, const Universe& universe,
+                 float step) {
+    GOL_TRACE_SCOPE("buildPoints");
+    points.clear();
+    states.clear();
+    universe.ForEachChunk([&](std::int32_t x, std::int32_t y, const Board& board) {
+        glm::vec2 origin(static_cast<float>(x) * Universe::ChunkSize * step,
+                         static_cast<float>(y) * Universe::ChunkSize * step);
+        buildPoints(points, states, board, origin, step);
+    });
+}
+
+void updateCheckpoints(Checkpointer& checkpointer) {
+    checkpointer.SetInterval(checkpoints_enabled ? checkpointInterval : 0);
+
+    auto stats = checkpointer.GetStats();
+    std::cout << "Checkpoints " << (checkpoints_enabled ? "enabled" : "disabled")
+              << ": interval = " << stats.interval
+              << ", written = " << stats.written
+              << ", skipped = " << stats.skipped
+              << ", last duration = " << stats.lastDurationMs << " ms"
+              << ", last stall = " << stats.lastStallMs << " ms"
+              << ", max stall = " << stats.maxStallMs << " ms" << std::endl;
+}
+
 void Application::Run() {
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -84,19 +214,49 @@ void Application::Run() {
     //-------------------
 
     resourceManager.LoadShader("res/quad.vert", "res/quad.frag", nullptr, "quad");
+    resourceManager.LoadShader("res/field.vert", "res/field.frag", nullptr, "field");
     // configure shaders
 
     updateProjection(resourceManager);
 
     auto shader = resourceManager.GetShader("quad");
-    shader->Use().SetVector4f("quad_color", glm::vec4(0.8f, 0.8f, 0.8f, 1.f));
+    shader->Use().SetInteger("palette", 0);
     Renderer renderer{shader};
 
-    int maxX = 1000;
-    int maxY = 1000;
+    unsigned int paletteTexture;
+    glGenTextures(1, &paletteTexture);
+    updatePalette(paletteTexture, rules[rule_index]);
+
+    FieldRenderer fieldRenderer{resourceManager.GetShader("field")};
+
+    auto hudShader = resourceManager.LoadShader("res/hud.vert", "res/hud.frag", nullptr, "hud");
+    Hud hud{hudShader, screenSettings};
+    GpuTimer gpuTimer;
+    FrameStats frameStats;
+
+    // the plane is unbounded, the soup it starts with and the Lenia board have this size
+    int soupWidth = 1000;
+    int soupHeight = 1000;
+
+    Universe universe{createEngine(rules[rule_index])};
+    Board seed{soupWidth, soupHeight};
+    seed.Randomize(std::random_device{}(), .3f);
+    universe.Paste(seed, -soupWidth / 2, -soupHeight / 2);
+
+    Checkpointer checkpointer{"checkpoints", 0};
+    History history{historyBudget};
+    CycleDetector cycles{cycleWindow};
+    cycles.Record(universe);
 
     std::vector<float> points;
-    points.reserve(maxX * maxY * 2);
+    points.reserve(static_cast<size_t>(soupWidth) * soupHeight * 2);
+    std::vector<std::uint8_t> states;
+
+    // created on the first switch to Lenia, the engine starts its worker threads
+    std::unique_ptr<LeniaEngine> lenia;
+    ContinuousBoard leniaBoard{soupWidth, soupHeight};
+    ContinuousBoard leniaNext{soupWidth, soupHeight};
+    std::uint64_t leniaGeneration = 0;
 
     //-------------------
 
@@ -105,19 +265,103 @@ void Application::Run() {
     unsigned int vbo;
     unsigned int vao;
 
+    GOL_TRACE_THREAD_NAME("render loop");
+
     while (!glfwWindowShouldClose(window)) {
+        GOL_TRACE_SCOPE("frame");
         // calculate delta time
         // --------------------
         float currentFrame = glfwGetTime();
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
-        glfwPollEvents();
+        frameStats.BeginFrame();
+        {
+            GOL_TRACE_SCOPE("poll");
+            glfwPollEvents();
+        }
+
+        if (checkpoints_changed) {
+            updateCheckpoints(checkpointer);
+            checkpoints_changed = false;
+        }
+
+        if (tracing_requested != Tracer::IsRecording()) {
+            if (tracing_requested) {
+                tracing_requested = Tracer::Start("trace.json");
+            } else {
+                Tracer::Stop();
+            }
+        }
+        frameStats.EndPhase(FramePhase::Poll);
+
+        if (rule_changed) {
+            // the board keeps its live cells, dying cells are dropped or kept as the state count allows
+            const Rule& rule = rules[rule_index];
+            universe.SetEngine(createEngine(rule));
+            history.Clear();
+            cycles.Clear();
+            updatePalette(paletteTexture, rule);
+            std::cout << "Rule " << FormatRule(rule) << std::endl;
+            rule_changed = false;
+        }
+
+        if (lenia_changed) {
+            // a fresh soup every time, the Life board is kept as it was
+            if (lenia_mode) {
+                if (!lenia) {
+                    lenia = std::make_unique<LeniaEngine>(LeniaRule{});
+                }
+                leniaBoard.Randomize(std::random_device{}(), .3f);
+                leniaGeneration = 0;
+                std::cout << "Rule " << FormatLeniaRule(lenia->GetRule()) << std::endl;
+            } else {
+                std::cout << "Rule " << FormatRule(rules[rule_index]) << std::endl;
+            }
+            lenia_changed = false;
+        }
+
+        // Lenia boards have no history to rewind and are not checkpointed
+        for (; rewind_requests > 0; rewind_requests--) {
+            GOL_TRACE_SCOPE("rewind");
+            if (!lenia_mode) {
+                history.StepBack(universe);
+            }
+        }
+
+        if (fast_forward_requested) {
+            GOL_TRACE_SCOPE("fast forward");
+            // the skipped generations are not in the history, rewinding stops at the jump
+            if (!lenia_mode && cycles.FastForward(universe, universe.GetGeneration() + fastForwardGenerations)) {
+                history.Clear();
+                std::cout << "Fast forward to generation " << universe.GetGeneration() << std::endl;
+            }
+            fast_forward_requested = false;
+        }
+
+        if (lenia_mode && (!paused || step_requests > 0)) {
+            GOL_TRACE_SCOPE("lenia");
+            lenia->Step(leniaBoard, leniaNext);
+            std::swap(leniaBoard, leniaNext);
+            leniaGeneration++;
+            step_requests = std::max(0, step_requests - 1);
+            frameStats.AddGenerations(1);
+        } else if (!paused || step_requests > 0) {
+            universe.Step();
+            history.Record(universe);
+            bool periodic = cycles.IsPeriodic();
+            cycles.Record(universe);
+            if (!periodic && cycles.IsPeriodic()) {
+                std::cout << "Period " << cycles.GetPeriod() << " from generation " << cycles.GetCycleStart()
+                          << std::endl;
+            }
+            checkpointer.OnGeneration(universe);
+            step_requests = std::max(0, step_requests - 1);
+            frameStats.AddGenerations(1);
+        }
+        frameStats.EndPhase(FramePhase::Step);
 
         // render
         // ------
-        glClearColor(0.2f, 0.2f, 0.2f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-
         float size = currentSize;
         float separator = 1;
 
@@ -128,62 +372,154 @@ void Application::Run() {
 
         glPointSize(size);
 
-        float fieldWidth = maxX * size + (maxX - 1) * separator;
-        float fieldHeight = maxY * size + (maxY - 1) * separator;
-
-        float startX = -fieldWidth / 2;
-        float startY = -fieldHeight / 2;
-
-        points.clear();
-
-        for (int i = 0; i < maxX; i++)
-        {
-            for (int j = 0; j < maxY; j++)
-            {
-                float x = startX + size * i + separator * i;
-                float y = startY + size * j + separator * j;
-
-                points.emplace_back(x);
-                points.emplace_back(y);
-            }
-        }
-
+        float step = size + separator;
 
         if (first)
         {
             glGenBuffers(1, &vbo);
         }
 
+        if (lenia_mode) {
+            GOL_TRACE_SCOPE("upload");
+            frameStats.AddUpload(fieldRenderer.Upload(leniaBoard));
+            points.clear();
+        } else {
+            buildPoints(points, states, universe, step);
+
+            GOL_TRACE_SCOPE("upload");
+            // the states of multi-state boards follow the points in the same buffer
+            size_t pointBytes = sizeof(float) * points.size();
+            glBindBuffer(GL_ARRAY_BUFFER, vbo);
+            glBufferData(GL_ARRAY_BUFFER, pointBytes + states.size(), nullptr, GL_DYNAMIC_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, pointBytes, points.data());
+            glBufferSubData(GL_ARRAY_BUFFER, pointBytes, states.size(), states.data());
+            frameStats.AddUpload(pointBytes + states.size());
+
+            if (first) {
+                glGenVertexArrays(1, &vao);
+                glBindVertexArray(vao);
+                glEnableVertexAttribArray(0);
+                glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0); //TODO: nullptr?
+            }
 
-        glBindBuffer(GL_ARRAY_BUFFER, vbo);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * points.size(), points.data(), GL_DYNAMIC_DRAW);
-
-
-        if (first) {
-            glGenVertexArrays(1, &vao);
+            // two-state boards upload no states, every point is a live cell
             glBindVertexArray(vao);
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0); //TODO: nullptr?
+            if (states.empty()) {
+                glDisableVertexAttribArray(1);
+                glVertexAttribI4ui(1, 1, 0, 0, 0);
+            } else {
+                glEnableVertexAttribArray(1);
+                glVertexAttribIPointer(1, 1, GL_UNSIGNED_BYTE, 1, (void*)pointBytes);
+            }
         }
 
         first = false;
 
         glBindBuffer(GL_ARRAY_BUFFER, 0);
         glBindVertexArray(0);
+        frameStats.EndPhase(FramePhase::Upload);
 
-        glBindVertexArray(vao);
-        glDrawArrays(GL_POINTS, 0, points.size() / 2);
-        glBindVertexArray(0);
+        gpuTimer.Begin();
+        {
+            GOL_TRACE_SCOPE("draw");
+            glClearColor(0.2f, 0.2f, 0.2f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            if (lenia_mode) {
+                // centred on the origin like the soup, every cell around the point it would be drawn as
+                glm::vec2 start(static_cast<float>(-soupWidth / 2), static_cast<float>(-soupHeight / 2));
+                fieldRenderer.Draw(start * step - step / 2, glm::vec2(soupWidth, soupHeight) * step);
+            } else {
+                shader->Use();
+                glActiveTexture(GL_TEXTURE0);
+                glBindTexture(GL_TEXTURE_1D, paletteTexture);
+                glBindVertexArray(vao);
+                glDrawArrays(GL_POINTS, 0, points.size() / 2);
+                glBindVertexArray(0);
+            }
+            frameStats.AddDrawCall();
+
+            if (show_hud) {
+                glm::vec2 position = hud.AddFrameStats(glm::vec2(10.f, 10.f), frameStats);
+                if (lenia_mode) {
+                    hud.AddText(position, "LENIA GENERATION " + std::to_string(leniaGeneration)
+                                          + "  MASS " + std::to_string(static_cast<long long>(leniaBoard.GetMass()))
+                                          + (paused ? "  PAUSED" : ""));
+                } else {
+                    hud.AddText(position, "GENERATION " + std::to_string(universe.GetGeneration())
+                                          + "  POPULATION " + std::to_string(universe.GetPopulation())
+                                          + "  CHUNKS " + std::to_string(universe.GetChunkCount())
+                                          + "  FROZEN " + std::to_string(universe.GetFrozenChunkCount())
+                                          + (cycles.IsPeriodic() ? "  PERIOD " + std::to_string(cycles.GetPeriod()) : ""));
+                    position.y += Hud::GetLineHeight();
+                    hud.AddText(position, "HISTORY " + std::to_string(history.GetSize()) + " GENERATIONS"
+                                          + (paused ? "  PAUSED" : ""));
+                }
+                frameStats.AddUpload(hud.Flush());
+                frameStats.AddDrawCall();
+            }
+        }
+        gpuTimer.End();
+
+        double gpuMs;
+        while (gpuTimer.Poll(gpuMs)) {
+            frameStats.SetGpuTime(gpuMs);
+        }
+        frameStats.EndPhase(FramePhase::Draw);
 
-        glfwSwapBuffers(window);
+        {
+            GOL_TRACE_SCOPE("swap");
+            glfwSwapBuffers(window);
+        }
+        frameStats.EndPhase(FramePhase::Swap);
+        frameStats.EndFrame();
     }
 
+    Tracer::Stop();
     glfwTerminate();
 }
 
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode) {
     if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
+
+    if (key == GLFW_KEY_C && action == GLFW_PRESS) {
+        checkpoints_enabled = !checkpoints_enabled;
+        checkpoints_changed = true;
+    }
+
+    if (key == GLFW_KEY_SPACE && action == GLFW_PRESS)
+        paused = !paused;
+
+    if (key == GLFW_KEY_H && action == GLFW_PRESS)
+        show_hud = !show_hud;
+
+    if (key == GLFW_KEY_T && action == GLFW_PRESS)
+        tracing_requested = !tracing_requested;
+
+    if (key == GLFW_KEY_L && action == GLFW_PRESS) {
+        lenia_mode = !lenia_mode;
+        lenia_changed = true;
+    }
+
+    if (key == GLFW_KEY_F && action == GLFW_PRESS)
+        fast_forward_requested = true;
+
+    if (key == GLFW_KEY_R && action == GLFW_PRESS) {
+        rule_index = (rule_index + 1) % static_cast<int>(sizeof(rules) / sizeof(rules[0]));
+        rule_changed = true;
+    }
+
+    // stepping in either direction pauses, holding the key repeats it
+    if (key == GLFW_KEY_LEFT && (action == GLFW_PRESS || action == GLFW_REPEAT)) {
+        paused = true;
+        rewind_requests++;
+    }
+
+    if (key == GLFW_KEY_RIGHT && (action == GLFW_PRESS || action == GLFW_REPEAT)) {
+        paused = true;
+        step_requests++;
+    }
 }
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
@@ -0,0 +1,78 @@
+#include <glad/glad.h>
+
+#include "field_renderer.h"
+#include "../profiling/trace.h"
+
+FieldRenderer::FieldRenderer(Shader* shader) : m_shader(shader), m_vao(0), m_vbo(0), m_texture(0),
+                                               m_width(0), m_height(0) {
+    glGenVertexArrays(1, &m_vao);
+    glGenBuffers(1, &m_vbo);
+
+    // position and texture coordinate of the corners of the quad
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glBufferData(GL_ARRAY_BUFFER, 6 * 4 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+
+    glGenTextures(1, &m_texture);
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    m_shader->Use().SetInteger("field", 0);
+}
+
+FieldRenderer::~FieldRenderer() {
+    glDeleteTextures(1, &m_texture);
+    glDeleteBuffers(1, &m_vbo);
+    glDeleteVertexArrays(1, &m_vao);
+}
+
+size_t FieldRenderer::Upload(const ContinuousBoard& board) {
+    GOL_TRACE_SCOPE("FieldRenderer::Upload");
+    int width = board.GetWidth();
+    int height = board.GetHeight();
+    if (width == 0 || height == 0) {
+        return 0;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    // rows are tightly packed floats, whatever the width
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    if (width != m_width || height != m_height) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, width, height, 0, GL_RED, GL_FLOAT, nullptr);
+        m_width = width;
+        m_height = height;
+    }
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RED, GL_FLOAT, board.GetRow(0));
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return sizeof(float) * static_cast<size_t>(width) * height;
+}
+
+void FieldRenderer::Draw(glm::vec2 origin, glm::vec2 size) {
+    glm::vec2 end = origin + size;
+    const float vertices[6][4] = {
+            {origin.x, origin.y, 0.f, 0.f}, {end.x, origin.y, 1.f, 0.f}, {origin.x, end.y, 0.f, 1.f},
+            {end.x, origin.y, 1.f, 0.f}, {end.x, end.y, 1.f, 1.f}, {origin.x, end.y, 0.f, 1.f}
+    };
+
+    m_shader->Use();
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    glBindVertexArray(m_vao);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
@@ -0,0 +1,35 @@
+#ifndef GAME_OF_LIFE_FIELD_RENDERER_H
+#define GAME_OF_LIFE_FIELD_RENDERER_H
+
+#include <glm/glm.hpp>
+
+#include "shader.h"
+#include "../simulation/continuous_board.h"
+
+// Draws a ContinuousBoard as a single textured quad: the states are uploaded into a float
+// texture every frame and the shader maps them to colours, so the cost does not depend on how
+// many cells are alive.
+class FieldRenderer {
+public:
+    explicit FieldRenderer(Shader* shader);
+    ~FieldRenderer();
+
+    FieldRenderer(const FieldRenderer&) = delete;
+    FieldRenderer& operator=(const FieldRenderer&) = delete;
+
+    // copies the states into the texture, resizing it with the board, returns the uploaded bytes
+    size_t Upload(const ContinuousBoard& board);
+
+    // the board with its top left corner at origin, size in world units
+    void Draw(glm::vec2 origin, glm::vec2 size);
+
+private:
+    Shader* m_shader;
+    unsigned int m_vao;
+    unsigned int m_vbo;
+    unsigned int m_texture;
+    int m_width;
+    int m_height;
+};
+
+#endif //GAME_OF_LIFE_FIELD_RENDERER_H
@@ -0,0 +1,105 @@
+#include "frame_stats.h"
+
+namespace {
+
+// weight of the newest sample in the displayed averages
+const double smoothing = .1;
+
+double millisecondsBetween(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+}
+
+const char* GetFramePhaseName(FramePhase phase) {
+    switch (phase) {
+        case FramePhase::Poll: return "POLL";
+        case FramePhase::Step: return "STEP";
+        case FramePhase::Upload: return "UPLOAD";
+        case FramePhase::Draw: return "DRAW";
+        case FramePhase::Swap: return "SWAP";
+        default: return "";
+    }
+}
+
+FrameStats::FrameStats() : m_phaseMs(), m_frameMs(0), m_gpuMs(0), m_history(), m_historyNext(0),
+                           m_frameUploadBytes(0), m_frameDrawCalls(0), m_uploadBytes(0), m_drawCalls(0),
+                           m_rateStart(Clock::now()), m_rateGenerations(0), m_generationsPerSecond(0) {
+}
+
+void FrameStats::BeginFrame() {
+    m_frameStart = Clock::now();
+    m_phaseStart = m_frameStart;
+    m_frameUploadBytes = 0;
+    m_frameDrawCalls = 0;
+}
+
+void FrameStats::EndPhase(FramePhase phase) {
+    auto now = Clock::now();
+    double& average = m_phaseMs[static_cast<size_t>(phase)];
+    average += (millisecondsBetween(m_phaseStart, now) - average) * smoothing;
+    m_phaseStart = now;
+}
+
+void FrameStats::EndFrame() {
+    auto now = Clock::now();
+    double frameMs = millisecondsBetween(m_frameStart, now);
+    m_frameMs += (frameMs - m_frameMs) * smoothing;
+
+    m_history[m_historyNext] = frameMs;
+    m_historyNext = (m_historyNext + 1) % HistorySize;
+
+    m_uploadBytes = m_frameUploadBytes;
+    m_drawCalls = m_frameDrawCalls;
+
+    double rateMs = millisecondsBetween(m_rateStart, now);
+    if (rateMs >= 1000) {
+        m_generationsPerSecond = static_cast<double>(m_rateGenerations) * 1000 / rateMs;
+        m_rateGenerations = 0;
+        m_rateStart = now;
+    }
+}
+
+void FrameStats::AddUpload(size_t bytes) {
+    m_frameUploadBytes += bytes;
+}
+
+void FrameStats::AddDrawCall() {
+    m_frameDrawCalls++;
+}
+
+void FrameStats::AddGenerations(std::uint64_t generations) {
+    m_rateGenerations += generations;
+}
+
+void FrameStats::SetGpuTime(double milliseconds) {
+    m_gpuMs += (milliseconds - m_gpuMs) * smoothing;
+}
+
+double FrameStats::GetPhaseMs(FramePhase phase) const {
+    return m_phaseMs[static_cast<size_t>(phase)];
+}
+
+double FrameStats::GetFrameMs() const {
+    return m_frameMs;
+}
+
+double FrameStats::GetGpuMs() const {
+    return m_gpuMs;
+}
+
+double FrameStats::GetGenerationsPerSecond() const {
+    return m_generationsPerSecond;
+}
+
+size_t FrameStats::GetUploadBytes() const {
+    return m_uploadBytes;
+}
+
+int FrameStats::GetDrawCalls() const {
+    return m_drawCalls;
+}
+
+double FrameStats::GetFrameHistory(int index) const {
+    return m_history[(m_historyNext + index) % HistorySize];
+}
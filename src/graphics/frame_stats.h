@@ -0,0 +1,69 @@
+#ifndef GAME_OF_LIFE_FRAME_STATS_H
+#define GAME_OF_LIFE_FRAME_STATS_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+enum class FramePhase {
+    Poll,
+    Step,
+    Upload,
+    Draw,
+    Swap,
+    Count
+};
+
+const char* GetFramePhaseName(FramePhase phase);
+
+// CPU time of every phase of the main loop plus per frame counters, smoothed for display.
+class FrameStats {
+public:
+    static const int HistorySize = 120;
+
+    FrameStats();
+
+    void BeginFrame();
+    // attributes the time since the previous phase (or the frame start) to phase
+    void EndPhase(FramePhase phase);
+    void EndFrame();
+
+    void AddUpload(size_t bytes);
+    void AddDrawCall();
+    void AddGenerations(std::uint64_t generations);
+    void SetGpuTime(double milliseconds);
+
+    double GetPhaseMs(FramePhase phase) const;
+    double GetFrameMs() const;
+    double GetGpuMs() const;
+    double GetGenerationsPerSecond() const;
+    size_t GetUploadBytes() const;
+    int GetDrawCalls() const;
+
+    // frame times in milliseconds, oldest first
+    double GetFrameHistory(int index) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Clock::time_point m_frameStart;
+    Clock::time_point m_phaseStart;
+    std::array<double, static_cast<size_t>(FramePhase::Count)> m_phaseMs;
+    double m_frameMs;
+    double m_gpuMs;
+
+    std::array<double, HistorySize> m_history;
+    int m_historyNext;
+
+    size_t m_frameUploadBytes;
+    int m_frameDrawCalls;
+    size_t m_uploadBytes;
+    int m_drawCalls;
+
+    Clock::time_point m_rateStart;
+    std::uint64_t m_rateGenerations;
+    double m_generationsPerSecond;
+};
+
+#endif //GAME_OF_LIFE_FRAME_STATS_H
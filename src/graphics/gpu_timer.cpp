@@ -0,0 +1,51 @@
+#include <glad/glad.h>
+
+#include "gpu_timer.h"
+
+GpuTimer::GpuTimer() : m_queries(), m_pending(), m_next(0), m_oldest(0), m_active(false) {
+    glGenQueries(QueryCount, m_queries);
+}
+
+GpuTimer::~GpuTimer() {
+    glDeleteQueries(QueryCount, m_queries);
+}
+
+void GpuTimer::Begin() {
+    if (m_pending[m_next]) {
+        return;
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, m_queries[m_next]);
+    m_active = true;
+}
+
+void GpuTimer::End() {
+    if (!m_active) {
+        return;
+    }
+
+    glEndQuery(GL_TIME_ELAPSED);
+    m_pending[m_next] = true;
+    m_next = (m_next + 1) % QueryCount;
+    m_active = false;
+}
+
+bool GpuTimer::Poll(double& milliseconds) {
+    if (!m_pending[m_oldest]) {
+        return false;
+    }
+
+    GLint available = 0;
+    glGetQueryObjectiv(m_queries[m_oldest], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        return false;
+    }
+
+    GLuint64 nanoseconds = 0;
+    glGetQueryObjectui64v(m_queries[m_oldest], GL_QUERY_RESULT, &nanoseconds);
+    milliseconds = static_cast<double>(nanoseconds) / 1e6;
+
+    m_pending[m_oldest] = false;
+    m_oldest = (m_oldest + 1) % QueryCount;
+    return true;
+}
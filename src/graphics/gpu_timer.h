@@ -0,0 +1,31 @@
+#ifndef GAME_OF_LIFE_GPU_TIMER_H
+#define GAME_OF_LIFE_GPU_TIMER_H
+
+// Measures GPU time between Begin and End with GL_TIME_ELAPSED queries. Queries rotate
+// through a small ring and results are only read once available, so the CPU never waits
+// for the GPU; a frame is left unmeasured when every query is still in flight.
+class GpuTimer {
+public:
+    GpuTimer();
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    void Begin();
+    void End();
+
+    // the oldest finished measurement not read yet
+    bool Poll(double& milliseconds);
+
+private:
+    static const int QueryCount = 3;
+
+    unsigned int m_queries[QueryCount];
+    bool m_pending[QueryCount];
+    int m_next;
+    int m_oldest;
+    bool m_active;
+};
+
+#endif //GAME_OF_LIFE_GPU_TIMER_H
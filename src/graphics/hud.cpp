@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+
+#include <glad/glad.h>
+#include <glm/ext/matrix_clip_space.hpp>
+
+#include "hud.h"
+#include "../profiling/trace.h"
+
+namespace {
+
+// glyph pixels row by row from the top, three pixels per row
+struct Glyph {
+    char character;
+    const char* pixels;
+};
+
+const Glyph font[] = {
+        {'0', "111101101101111"}, {'1', "010110010010111"}, {'2', "111001111100111"},
+        {'3', "111001111001111"}, {'4', "101101111001001"}, {'5', "111100111001111"},
+        {'6', "111100111101111"}, {'7', "111001001001001"}, {'8', "111101111101111"},
+        {'9', "111101111001111"}, {'A', "010101111101101"}, {'B', "110101110101110"},
+        {'C', "011100100100011"}, {'D', "110101101101110"}, {'E', "111100110100111"},
+        {'F', "111100110100100"}, {'G', "011100101101011"}, {'H', "101101111101101"},
+        {'I', "111010010010111"}, {'J', "001001001101010"}, {'K', "101101110101101"},
+        {'L', "100100100100111"}, {'M', "101111111101101"}, {'N', "110101101101101"},
+        {'O', "010101101101010"}, {'P', "110101110100100"}, {'Q', "010101101110011"},
+        {'R', "110101110101101"}, {'S', "011100010001110"}, {'T', "111010010010010"},
+        {'U', "101101101101111"}, {'V', "101101101101010"}, {'W', "101101111111101"},
+        {'X', "101101010101101"}, {'Y', "101101010010010"}, {'Z', "111001010100111"},
+        {'.', "000000000000010"}, {':', "000010000010000"}, {'/', "001001010100100"},
+        {'-', "000000111000000"}, {'%', "101001010100101"}, {'(', "010100100100010"},
+        {')', "010001001001010"}, {'=', "000111000111000"}, {'+', "000010111010000"},
+        {',', "000000000010100"},
+};
+
+const float pixelSize = 2.f;
+const float glyphAdvance = 4 * pixelSize;
+const float lineHeight = 7 * pixelSize;
+
+const float histogramBarWidth = 2.f;
+const float histogramHeight = 40.f;
+// frame time drawn at full histogram height
+const double histogramScaleMs = 1000. / 30.;
+
+const glm::vec4 panelColor{0.f, 0.f, 0.f, .6f};
+const glm::vec4 goodFrameColor{.3f, .8f, .3f, 1.f};
+const glm::vec4 slowFrameColor{.9f, .8f, .2f, 1.f};
+const glm::vec4 hitchFrameColor{.9f, .3f, .2f, 1.f};
+
+std::string format(const char* format, double value) {
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), format, value);
+    return buffer;
+}
+
+}
+
+Hud::Hud(Shader* shader, const ScreenSettings& screenSettings) : m_shader(shader), m_vao(0), m_vbo(0),
+                                                                 m_vertices(), m_glyphs() {
+    for (const Glyph& glyph : font) {
+        std::uint16_t bits = 0;
+        for (int i = 0; i < 15; i++) {
+            bits |= (glyph.pixels[i] == '1' ? 1 : 0) << i;
+        }
+        m_glyphs[static_cast<unsigned char>(glyph.character)] = bits;
+    }
+
+    auto width = static_cast<float>(screenSettings.GetWidth());
+    auto height = static_cast<float>(screenSettings.GetHeight());
+    m_shader->SetMatrix4("projection", glm::ortho(0.f, width, height, 0.f, -1.f, 1.f), true);
+
+    glGenVertexArrays(1, &m_vao);
+    glGenBuffers(1, &m_vbo);
+
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(2 * sizeof(float)));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+Hud::~Hud() {
+    glDeleteBuffers(1, &m_vbo);
+    glDeleteVertexArrays(1, &m_vao);
+}
+
+void Hud::AddRectangle(glm::vec2 position, glm::vec2 size, glm::vec4 color) {
+    const float corners[6][2] = {
+            {0.f, 0.f}, {1.f, 0.f}, {0.f, 1.f},
+            {1.f, 0.f}, {1.f, 1.f}, {0.f, 1.f}
+    };
+
+    for (const auto& corner : corners) {
+        m_vertices.insert(m_vertices.end(), {
+                position.x + corner[0] * size.x, position.y + corner[1] * size.y,
+                color.x, color.y, color.z, color.w
+        });
+    }
+}
+
+void Hud::AddText(glm::vec2 position, const std::string& text, glm::vec4 color) {
+    for (char character : text) {
+        std::uint16_t glyph = m_glyphs[std::toupper(static_cast<unsigned char>(character)) & 127];
+        for (int i = 0; i < 15; i++) {
+            if (glyph & (1 << i)) {
+                glm::vec2 pixel{position.x + static_cast<float>(i % 3) * pixelSize,
+                                position.y + static_cast<float>(i / 3) * pixelSize};
+                AddRectangle(pixel, glm::vec2(pixelSize), color);
+            }
+        }
+        position.x += glyphAdvance;
+    }
+}
+
+glm::vec2 Hud::AddFrameStats(glm::vec2 position, const FrameStats& stats) {
+    const float padding = 6.f;
+    const int phaseCount = static_cast<int>(FramePhase::Count);
+    float width = FrameStats::HistorySize * histogramBarWidth + 2 * padding;
+    float height = 2 * padding + histogramHeight + padding + (4 + phaseCount) * lineHeight;
+    AddRectangle(position, glm::vec2(width, height), panelColor);
+
+    glm::vec2 cursor = position + glm::vec2(padding);
+
+    // frame time histogram, the newest frame on the right
+    for (int i = 0; i < FrameStats::HistorySize; i++) {
+        double frameMs = stats.GetFrameHistory(i);
+        auto barHeight = static_cast<float>(std::min(frameMs / histogramScaleMs, 1.) * histogramHeight);
+        glm::vec4 color = frameMs <= 1000. / 60. ? goodFrameColor
+                        : frameMs <= 1000. / 30. ? slowFrameColor
+                        : hitchFrameColor;
+        AddRectangle(glm::vec2(cursor.x + static_cast<float>(i) * histogramBarWidth, cursor.y + histogramHeight - barHeight),
+                     glm::vec2(histogramBarWidth, barHeight), color);
+    }
+    cursor.y += histogramHeight + padding;
+
+    double frameMs = stats.GetFrameMs();
+    AddText(cursor, format("FRAME %.2f MS", frameMs) + format("  %.0f FPS", frameMs > 0 ? 1000. / frameMs : 0.));
+    cursor.y += lineHeight;
+    AddText(cursor, format("GPU %.2f MS", stats.GetGpuMs()));
+    cursor.y += lineHeight;
+
+    for (int phase = 0; phase < phaseCount; phase++) {
+        auto framePhase = static_cast<FramePhase>(phase);
+        AddText(cursor, std::string(GetFramePhaseName(framePhase)) + format(" %.2f MS", stats.GetPhaseMs(framePhase)));
+        cursor.y += lineHeight;
+    }
+
+    AddText(cursor, format("GENS/S %.1f", stats.GetGenerationsPerSecond()));
+    cursor.y += lineHeight;
+    AddText(cursor, format("UPLOAD %.2f MB", static_cast<double>(stats.GetUploadBytes()) / (1024 * 1024))
+                    + format("  DRAW CALLS %.0f", stats.GetDrawCalls()));
+
+    return glm::vec2(position.x, position.y + height + padding);
+}
+
+size_t Hud::Flush() {
+    GOL_TRACE_SCOPE("Hud::Flush");
+    size_t bytes = sizeof(float) * m_vertices.size();
+    if (bytes == 0) {
+        return 0;
+    }
+
+    m_shader->Use();
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(bytes), m_vertices.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glBindVertexArray(m_vao);
+    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(m_vertices.size() / 6));
+    glBindVertexArray(0);
+
+    m_vertices.clear();
+    return bytes;
+}
+
+float Hud::GetLineHeight() {
+    return lineHeight;
+}
@@ -0,0 +1,45 @@
+#ifndef GAME_OF_LIFE_HUD_H
+#define GAME_OF_LIFE_HUD_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "shader.h"
+#include "frame_stats.h"
+#include "screen_settings.h"
+
+// Screen space overlay made of coloured rectangles, text uses a built-in 3x5 pixel font.
+// Primitives are collected between frames and drawn with a single call by Flush.
+class Hud {
+public:
+    Hud(Shader* shader, const ScreenSettings& screenSettings);
+    ~Hud();
+
+    Hud(const Hud&) = delete;
+    Hud& operator=(const Hud&) = delete;
+
+    // positions are in pixels from the top left corner of the window
+    void AddRectangle(glm::vec2 position, glm::vec2 size, glm::vec4 color);
+    void AddText(glm::vec2 position, const std::string& text, glm::vec4 color = glm::vec4(1.f));
+
+    // panel with the frame time histogram and the phase timings, returns the position below it
+    glm::vec2 AddFrameStats(glm::vec2 position, const FrameStats& stats);
+
+    // uploads and draws everything added since the last flush, returns the uploaded bytes
+    size_t Flush();
+
+    static float GetLineHeight();
+
+private:
+    Shader* m_shader;
+    unsigned int m_vao;
+    unsigned int m_vbo;
+    std::vector<float> m_vertices;
+    std::array<std::uint16_t, 128> m_glyphs;
+};
+
+#endif //GAME_OF_LIFE_HUD_H
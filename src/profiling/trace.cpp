@@ -0,0 +1,237 @@
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "trace.h"
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    std::int64_t begin;
+    std::int64_t end;
+};
+
+// single producer (the owning thread), single consumer (the flush thread)
+class TraceBuffer {
+public:
+    static const size_t Capacity = 1 << 14;
+
+    explicit TraceBuffer(int threadId) : m_threadId(threadId), m_threadName(nullptr), m_namedThreadName(nullptr),
+                                         m_dropped(0), m_head(0), m_tail(0) {
+    }
+
+    void Push(const TraceEvent& event) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == Capacity) {
+            // never block the traced thread, the flush thread is behind
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        m_events[head % Capacity] = event;
+        m_head.store(head + 1, std::memory_order_release);
+    }
+
+    template<typename Function>
+    void Drain(Function function) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t head = m_head.load(std::memory_order_acquire);
+        for (; tail != head; tail++) {
+            function(m_events[tail % Capacity]);
+        }
+        m_tail.store(tail, std::memory_order_release);
+    }
+
+    int m_threadId;
+    std::atomic<const char*> m_threadName;
+    // name already written to the trace
+    const char* m_namedThreadName;
+    std::atomic<std::uint64_t> m_dropped;
+
+private:
+    std::array<TraceEvent, Capacity> m_events;
+    std::atomic<size_t> m_head;
+    std::atomic<size_t> m_tail;
+};
+
+struct TraceState {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<TraceBuffer>> buffers;
+    int nextThreadId = 1;
+
+    std::mutex flushMutex;
+    std::condition_variable flushCondition;
+    std::thread flushThread;
+    bool stop = false;
+
+    std::ofstream file;
+    bool firstEvent = true;
+    std::int64_t start = 0;
+    std::uint64_t dropped = 0;
+};
+
+TraceState& state() {
+    static TraceState traceState;
+    return traceState;
+}
+
+// owned by the thread and the registry, the registry lets go once the thread has exited
+thread_local std::shared_ptr<TraceBuffer> threadBuffer;
+
+TraceBuffer& getThreadBuffer() {
+    if (!threadBuffer) {
+        TraceState& trace = state();
+        std::lock_guard<std::mutex> lock(trace.mutex);
+        threadBuffer = std::make_shared<TraceBuffer>(trace.nextThreadId++);
+        trace.buffers.push_back(threadBuffer);
+    }
+    return *threadBuffer;
+}
+
+void writeSeparator(TraceState& trace) {
+    trace.file << (trace.firstEvent ? "\n" : ",\n");
+    trace.firstEvent = false;
+}
+
+void writeBuffer(TraceState& trace, TraceBuffer& buffer) {
+    const char* threadName = buffer.m_threadName.load(std::memory_order_acquire);
+    if (threadName != nullptr && threadName != buffer.m_namedThreadName) {
+        writeSeparator(trace);
+        trace.file << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << buffer.m_threadId
+                   << R"(,"args":{"name":")" << threadName << R"("}})";
+        buffer.m_namedThreadName = threadName;
+    }
+
+    buffer.Drain([&trace, &buffer](const TraceEvent& event) {
+        writeSeparator(trace);
+        trace.file << R"({"name":")" << event.name << R"(","ph":"X","pid":1,"tid":)" << buffer.m_threadId
+                   << R"(,"ts":)" << static_cast<double>(event.begin - trace.start) / 1000.
+                   << R"(,"dur":)" << static_cast<double>(event.end - event.begin) / 1000. << "}";
+    });
+    trace.dropped += buffer.m_dropped.exchange(0, std::memory_order_relaxed);
+}
+
+void flushBuffers(TraceState& trace) {
+    std::vector<std::shared_ptr<TraceBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(trace.mutex);
+        buffers = trace.buffers;
+    }
+    for (auto& buffer : buffers) {
+        writeBuffer(trace, *buffer);
+    }
+    // the copies would keep every buffer looking owned by a live thread
+    buffers.clear();
+
+    std::vector<std::shared_ptr<TraceBuffer>> exited;
+    {
+        std::lock_guard<std::mutex> lock(trace.mutex);
+        for (size_t i = 0; i < trace.buffers.size();) {
+            if (trace.buffers[i].use_count() == 1) {
+                exited.push_back(std::move(trace.buffers[i]));
+                trace.buffers.erase(trace.buffers.begin() + static_cast<std::ptrdiff_t>(i));
+            } else {
+                i++;
+            }
+        }
+    }
+    // the threads are gone, this takes what they pushed after the pass above
+    for (auto& buffer : exited) {
+        writeBuffer(trace, *buffer);
+    }
+}
+
+void flushLoop() {
+    TraceState& trace = state();
+    GOL_TRACE_THREAD_NAME("trace flush");
+
+    std::unique_lock<std::mutex> lock(trace.flushMutex);
+    while (!trace.stop) {
+        trace.flushCondition.wait_for(lock, std::chrono::milliseconds(100));
+        flushBuffers(trace);
+    }
+}
+
+}
+
+std::atomic<bool> Tracer::s_recording{false};
+
+bool Tracer::Start(const std::string& path) {
+    if (!IsCompiledIn()) {
+        std::cout << "WARNING::TRACE: tracing is disabled, configure with GOL_ENABLE_TRACING=ON" << std::endl;
+        return false;
+    }
+    if (IsRecording()) {
+        return true;
+    }
+
+    TraceState& trace = state();
+    trace.file.open(path, std::ios::trunc);
+    if (!trace.file) {
+        std::cout << "ERROR::TRACE: Failed to open " << path << std::endl;
+        return false;
+    }
+
+    trace.file << R"({"displayTimeUnit":"ms","traceEvents":[)";
+    trace.firstEvent = true;
+    trace.start = Now();
+    trace.dropped = 0;
+    trace.stop = false;
+    {
+        // names were written to the previous trace, repeat them in this one
+        std::lock_guard<std::mutex> lock(trace.mutex);
+        for (auto& buffer : trace.buffers) {
+            buffer->m_namedThreadName = nullptr;
+        }
+    }
+    trace.flushThread = std::thread(flushLoop);
+
+    s_recording.store(true, std::memory_order_relaxed);
+    std::cout << "Tracing to " << path << std::endl;
+    return true;
+}
+
+void Tracer::Stop() {
+    if (!IsRecording()) {
+        return;
+    }
+    s_recording.store(false, std::memory_order_relaxed);
+
+    TraceState& trace = state();
+    {
+        std::lock_guard<std::mutex> lock(trace.flushMutex);
+        trace.stop = true;
+    }
+    trace.flushCondition.notify_one();
+    trace.flushThread.join();
+
+    // spans that were in flight when recording stopped
+    flushBuffers(trace);
+    trace.file << "\n]}\n";
+    trace.file.close();
+
+    std::cout << "Tracing stopped";
+    if (trace.dropped > 0) {
+        std::cout << ", " << trace.dropped << " spans dropped";
+    }
+    std::cout << std::endl;
+}
+
+std::int64_t Tracer::Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracer::Record(const char* name, std::int64_t begin, std::int64_t end) {
+    getThreadBuffer().Push(TraceEvent{name, begin, end});
+}
+
+void Tracer::SetThreadName(const char* name) {
+    getThreadBuffer().m_threadName.store(name, std::memory_order_release);
+}
@@ -0,0 +1,71 @@
+#ifndef GAME_OF_LIFE_TRACE_H
+#define GAME_OF_LIFE_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Span tracing in the Chrome trace event format (chrome://tracing, ui.perfetto.dev).
+//
+// Every thread records finished spans into its own lock-free ring buffer, a background thread
+// drains the buffers into the trace file. Span and thread names must be string literals.
+// Without GOL_ENABLE_TRACING the GOL_TRACE_* macros compile to nothing.
+class Tracer {
+public:
+    static constexpr bool IsCompiledIn() {
+#if defined(GOL_ENABLE_TRACING)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static bool Start(const std::string& path);
+    static void Stop();
+
+    static bool IsRecording() {
+        return s_recording.load(std::memory_order_relaxed);
+    }
+
+    static std::int64_t Now();
+    static void Record(const char* name, std::int64_t begin, std::int64_t end);
+    static void SetThreadName(const char* name);
+
+private:
+    static std::atomic<bool> s_recording;
+};
+
+#if defined(GOL_ENABLE_TRACING)
+
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) : m_name(name), m_begin(Tracer::IsRecording() ? Tracer::Now() : -1) {
+    }
+
+    ~TraceScope() {
+        if (m_begin >= 0) {
+            Tracer::Record(m_name, m_begin, Tracer::Now());
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* m_name;
+    std::int64_t m_begin;
+};
+
+#define GOL_TRACE_CONCAT_IMPL(a, b) a##b
+#define GOL_TRACE_CONCAT(a, b) GOL_TRACE_CONCAT_IMPL(a, b)
+#define GOL_TRACE_SCOPE(name) TraceScope GOL_TRACE_CONCAT(traceScope, __LINE__){name}
+#define GOL_TRACE_THREAD_NAME(name) Tracer::SetThreadName(name)
+
+#else
+
+#define GOL_TRACE_SCOPE(name) ((void)0)
+#define GOL_TRACE_THREAD_NAME(name) ((void)0)
+
+#endif
+
+#endif //GAME_OF_LIFE_TRACE_H
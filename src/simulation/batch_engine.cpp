@@ -0,0 +1,94 @@
+#include "batch_engine.h"
+#include "bit_kernel.h"
+
+namespace {
+
+// next generation of the count words of a transposed row from word 0; neighbouring cells are
+// lanes words apart, above, row and below must allow reading lanes words before and after
+template<typename Kernel>
+void stepTransposedRow(const Kernel& nextState, const std::uint64_t* above, const std::uint64_t* row,
+                       const std::uint64_t* below, std::uint64_t* out, int count, int lanes) {
+    for (int i = 0; i < count; i++) {
+        out[i] = nextState(row[i], CountNeighbourWords(above[i - lanes], above[i], above[i + lanes],
+                                                       row[i - lanes], row[i + lanes],
+                                                       below[i - lanes], below[i], below[i + lanes]));
+    }
+}
+
+// circuits are interpreted over RuleCircuit::Lanes words at a time, as in StepRowWords
+void stepTransposedRow(const CircuitRuleKernel& kernel, const std::uint64_t* above, const std::uint64_t* row,
+                       const std::uint64_t* below, std::uint64_t* out, int count, int lanes) {
+    constexpr int circuitLanes = RuleCircuit::Lanes;
+    const RuleCircuit& circuit = *kernel.circuit;
+    int inputCount = circuit.GetInputCount();
+    static thread_local std::vector<std::uint64_t> registers;
+    registers.resize(static_cast<size_t>(circuit.GetRegisterCount()) * circuitLanes);
+
+    const std::uint64_t* rows[3] = {above, row, below};
+    for (int first = 0; first < count; first += circuitLanes) {
+        int used = std::min(circuitLanes, count - first);
+        if (used < circuitLanes) {
+            std::fill(registers.begin(), registers.begin() + inputCount * circuitLanes, 0);
+        }
+
+        for (int lane = 0; lane < used; lane++) {
+            int i = first + lane;
+            if (inputCount == RuleCircuit::CountInputCount) {
+                NeighbourCount neighbours = CountNeighbourWords(above[i - lanes], above[i], above[i + lanes],
+                                                                row[i - lanes], row[i + lanes],
+                                                                below[i - lanes], below[i], below[i + lanes]);
+                registers[0 * circuitLanes + lane] = neighbours.s0;
+                registers[1 * circuitLanes + lane] = neighbours.s1;
+                registers[2 * circuitLanes + lane] = neighbours.s2;
+                registers[3 * circuitLanes + lane] = neighbours.s3;
+                registers[4 * circuitLanes + lane] = row[i];
+            } else {
+                // bitplanes of the neighbourhood index, bit 3 * row + column from the north west
+                for (int r = 0; r < 3; r++) {
+                    registers[(3 * r + 0) * circuitLanes + lane] = rows[r][i - lanes];
+                    registers[(3 * r + 1) * circuitLanes + lane] = rows[r][i];
+                    registers[(3 * r + 2) * circuitLanes + lane] = rows[r][i + lanes];
+                }
+            }
+        }
+
+        const std::uint64_t* result = circuit.Evaluate(registers.data());
+        std::copy(result, result + used, out + first);
+    }
+}
+
+}
+
+BatchEngine::BatchEngine(const Rule& rule) : m_rule(rule) {
+    // a circuit of its own rather than one from the shared cache, which would keep the circuit of
+    // every rule of a sweep
+    if (Supports(rule) && !VisitFixedRuleKernel(rule, [](const auto&) {})) {
+        m_circuit = std::make_shared<const RuleCircuit>(rule);
+    }
+}
+
+bool BatchEngine::Supports(const Rule& rule) {
+    return rule.states == 2 && rule.radius == 1;
+}
+
+const Rule& BatchEngine::GetRule() const {
+    return m_rule;
+}
+
+void BatchEngine::Step(const BoardBatch& current, BoardBatch& next) const {
+    int height = current.GetHeight();
+    int lanes = current.GetLaneWords();
+    int count = current.GetWidth() * lanes;
+
+    auto step = [&](const auto& kernel) {
+        for (int y = 0; y < height; y++) {
+            stepTransposedRow(kernel, current.GetCell(0, y - 1), current.GetCell(0, y), current.GetCell(0, y + 1),
+                              next.GetCell(0, y), count, lanes);
+        }
+    };
+    if (!VisitFixedRuleKernel(m_rule, step)) {
+        step(CircuitRuleKernel{m_circuit});
+    }
+
+    next.RefreshHalo();
+}
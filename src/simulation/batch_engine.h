@@ -0,0 +1,32 @@
+#ifndef GAME_OF_LIFE_BATCH_ENGINE_H
+#define GAME_OF_LIFE_BATCH_ENGINE_H
+
+#include <memory>
+
+#include "board_batch.h"
+#include "rule.h"
+#include "rule_circuit.h"
+
+// Steps every board of a BoardBatch at once with the bit-sliced adder network of the bitwise
+// engine. The neighbours of a cell are whole words in a transposed batch, so the network runs
+// without shifts on 64 boards per word. Two-state rules of radius 1 only, outer-totalistic or
+// isotropic.
+class BatchEngine {
+public:
+    explicit BatchEngine(const Rule& rule);
+
+    static bool Supports(const Rule& rule);
+
+    const Rule& GetRule() const;
+
+    // writes the generation following current into next, both batches have the same size,
+    // board count and topology; the halo of current must be up to date
+    void Step(const BoardBatch& current, BoardBatch& next) const;
+
+private:
+    Rule m_rule;
+    // rules without a specialized kernel only
+    std::shared_ptr<const RuleCircuit> m_circuit;
+};
+
+#endif //GAME_OF_LIFE_BATCH_ENGINE_H
@@ -0,0 +1,232 @@
+#ifndef GAME_OF_LIFE_BIT_KERNEL_H
+#define GAME_OF_LIFE_BIT_KERNEL_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "board.h"
+#include "rule.h"
+#include "rule_circuit.h"
+
+// Neighbour count of 64 cells at once, bit-sliced: bit i of s0..s3 is the count of cell i.
+struct NeighbourCount {
+    std::uint64_t s0;
+    std::uint64_t s1;
+    std::uint64_t s2;
+    std::uint64_t s3;
+};
+
+inline void FullAdd(std::uint64_t a, std::uint64_t b, std::uint64_t c, std::uint64_t& sum, std::uint64_t& carry) {
+    std::uint64_t t = a ^ b;
+    sum = t ^ c;
+    carry = (a & b) | (t & c);
+}
+
+// cells of the word west and east of every bit, pulling the edge bits from the neighbouring words
+inline std::uint64_t ShiftWest(std::uint64_t left, std::uint64_t word) {
+    return (word << 1) | (left >> 63);
+}
+
+inline std::uint64_t ShiftEast(std::uint64_t word, std::uint64_t right) {
+    return (word >> 1) | (right << 63);
+}
+
+// adder network over eight neighbour words, the rows above and below west to east and the west
+// and east neighbours in the row
+inline NeighbourCount CountNeighbourWords(std::uint64_t northWest, std::uint64_t north, std::uint64_t northEast,
+                                          std::uint64_t west, std::uint64_t east,
+                                          std::uint64_t southWest, std::uint64_t south, std::uint64_t southEast) {
+    std::uint64_t sumA, carryA, sumB, carryB;
+    FullAdd(northWest, north, northEast, sumA, carryA);
+    FullAdd(west, east, southWest, sumB, carryB);
+    std::uint64_t sumC = south ^ southEast;
+    std::uint64_t carryC = south & southEast;
+
+    NeighbourCount count;
+    std::uint64_t carryOnes;
+    FullAdd(sumA, sumB, sumC, count.s0, carryOnes);
+
+    std::uint64_t twos, fours;
+    FullAdd(carryA, carryB, carryC, twos, fours);
+    count.s1 = twos ^ carryOnes;
+    std::uint64_t moreFours = twos & carryOnes;
+    count.s2 = fours ^ moreFours;
+    count.s3 = fours & moreFours;
+    return count;
+}
+
+// adder network over the eight neighbours of every bit of above[0], row[0], below[0];
+// the pointers must allow reading index -1 and 1
+inline NeighbourCount CountNeighbours(const std::uint64_t* above, const std::uint64_t* row,
+                                      const std::uint64_t* below) {
+    std::uint64_t a = above[0];
+    std::uint64_t b = row[0];
+    std::uint64_t c = below[0];
+    return CountNeighbourWords(ShiftWest(above[-1], a), a, ShiftEast(a, above[1]),
+                               ShiftWest(row[-1], b), ShiftEast(b, row[1]),
+                               ShiftWest(below[-1], c), c, ShiftEast(c, below[1]));
+}
+
+// B3/S23 on a bit-sliced count, a count of 8 has s1 clear so s3 needs no test
+inline std::uint64_t ConwayNextState(std::uint64_t alive, const NeighbourCount& count) {
+    return count.s1 & ~count.s2 & (count.s0 | alive);
+}
+
+// bits whose neighbour count is exactly n, counts only reach 8 when s0..s2 are clear
+inline std::uint64_t CountEquals(const NeighbourCount& count, int n) {
+    if (n == 8) {
+        return count.s3;
+    }
+    return ((n & 1) ? count.s0 : ~count.s0) &
+           ((n & 2) ? count.s1 : ~count.s1) &
+           ((n & 4) ? count.s2 : ~count.s2) & ~count.s3;
+}
+
+// Next state functors for RuleKernel visitors: operator()(alive, count) returns the next
+// generation of the 64 cells.
+
+// rule known at compile time, the count comparisons fold into one expression per rule
+template<std::uint16_t Birth, std::uint16_t Survival>
+struct FixedRuleKernel {
+    template<std::uint16_t Counts, int... N>
+    static std::uint64_t matching(const NeighbourCount& count, std::integer_sequence<int, N...>) {
+        return (std::uint64_t(0) | ... | (((Counts >> N) & 1) ? CountEquals(count, N) : 0));
+    }
+
+    std::uint64_t operator()(std::uint64_t alive, const NeighbourCount& count) const {
+        auto counts = std::make_integer_sequence<int, 9>();
+        return (matching<Birth>(count, counts) & ~alive) | (matching<Survival>(count, counts) & alive);
+    }
+};
+
+template<>
+struct FixedRuleKernel<ConwayRule.birth, ConwayRule.survival> {
+    std::uint64_t operator()(std::uint64_t alive, const NeighbourCount& count) const {
+        return ConwayNextState(alive, count);
+    }
+};
+
+// any rule, through the circuit compiled for it
+struct CircuitRuleKernel {
+    std::shared_ptr<const RuleCircuit> circuit;
+};
+
+// next generation of words [0, count) of a row; above, row and below point at word 0 and must
+// allow reading words -1 and count
+template<typename Kernel>
+inline void StepRowWords(const Kernel& nextState, const std::uint64_t* above, const std::uint64_t* row,
+                         const std::uint64_t* below, std::uint64_t* out, int count) {
+    for (int w = 0; w < count; w++) {
+        out[w] = nextState(row[w], CountNeighbours(above + w, row + w, below + w));
+    }
+}
+
+// circuits are interpreted over RuleCircuit::Lanes words at a time
+inline void StepRowWords(const CircuitRuleKernel& kernel, const std::uint64_t* above, const std::uint64_t* row,
+                         const std::uint64_t* below, std::uint64_t* out, int count) {
+    constexpr int lanes = RuleCircuit::Lanes;
+    const RuleCircuit& circuit = *kernel.circuit;
+    int inputCount = circuit.GetInputCount();
+    static thread_local std::vector<std::uint64_t> registers;
+    registers.resize(static_cast<size_t>(circuit.GetRegisterCount()) * lanes);
+
+    const std::uint64_t* rows[3] = {above, row, below};
+    for (int first = 0; first < count; first += lanes) {
+        int used = std::min(lanes, count - first);
+        if (used < lanes) {
+            std::fill(registers.begin(), registers.begin() + inputCount * lanes, 0);
+        }
+
+        for (int lane = 0; lane < used; lane++) {
+            int w = first + lane;
+            if (inputCount == RuleCircuit::CountInputCount) {
+                NeighbourCount neighbours = CountNeighbours(above + w, row + w, below + w);
+                registers[0 * lanes + lane] = neighbours.s0;
+                registers[1 * lanes + lane] = neighbours.s1;
+                registers[2 * lanes + lane] = neighbours.s2;
+                registers[3 * lanes + lane] = neighbours.s3;
+                registers[4 * lanes + lane] = row[w];
+            } else {
+                // bitplanes of the neighbourhood index, bit 3 * row + column from the north west
+                for (int r = 0; r < 3; r++) {
+                    const std::uint64_t* words = rows[r] + w;
+                    registers[(3 * r + 0) * lanes + lane] = ShiftWest(words[-1], words[0]);
+                    registers[(3 * r + 1) * lanes + lane] = words[0];
+                    registers[(3 * r + 2) * lanes + lane] = ShiftEast(words[0], words[1]);
+                }
+            }
+        }
+
+        const std::uint64_t* result = circuit.Evaluate(registers.data());
+        std::copy(result, result + used, out + first);
+    }
+}
+
+// Generations step of a row of a multi-state board, given the next live cells of the two-state
+// rule in nextAlive: live cells that do not survive start dying in state 2, dying cells count up
+// their state until they are dead again and cells are only born into dead cells
+inline void StepGenerationsRow(const Board& current, Board& next, int y, const std::uint64_t* nextAlive,
+                               int states) {
+    int planeCount = current.GetPlaneCount();
+    for (int w = 0; w < current.GetWordsPerRow(); w++) {
+        // state + 1 of every cell as a ripple carry over the planes, and where it reaches the
+        // state count the dying cell is dead again
+        std::array<std::uint64_t, 8> incremented{};
+        std::uint64_t higher = 0;
+        std::uint64_t carry = ~std::uint64_t(0);
+        std::uint64_t wrapped = ~std::uint64_t(0);
+        for (int plane = 0; plane < planeCount; plane++) {
+            std::uint64_t bit = current.GetRow(y, plane)[w];
+            higher |= plane > 0 ? bit : 0;
+            incremented[plane] = bit ^ carry;
+            carry &= bit;
+            wrapped &= (states >> plane) & 1 ? incremented[plane] : ~incremented[plane];
+        }
+
+        // state 1 is alive, any state above it dying
+        std::uint64_t alive = current.GetRow(y)[w] & ~higher;
+        std::uint64_t dying = higher;
+        std::uint64_t stillDying = dying & ~wrapped;
+        std::uint64_t live = nextAlive[w] & ~dying;
+        std::uint64_t startDying = alive & ~nextAlive[w];
+        for (int plane = 0; plane < planeCount; plane++) {
+            std::uint64_t word = incremented[plane] & stillDying;
+            word |= plane == 0 ? live : 0;
+            word |= plane == 1 ? startDying : 0;
+            next.GetRow(y, plane)[w] = word;
+        }
+    }
+}
+
+// calls visit with the compile time specialization of the common rules and returns true, false
+// without calling it for the other rules
+template<typename Visitor>
+bool VisitFixedRuleKernel(const Rule& rule, Visitor&& visit) {
+    if (rule == ConwayRule) {
+        visit(FixedRuleKernel<ConwayRule.birth, ConwayRule.survival>());
+    } else if (rule == HighLifeRule) {
+        visit(FixedRuleKernel<HighLifeRule.birth, HighLifeRule.survival>());
+    } else if (rule == SeedsRule) {
+        visit(FixedRuleKernel<SeedsRule.birth, SeedsRule.survival>());
+    } else if (rule == DayAndNightRule) {
+        visit(FixedRuleKernel<DayAndNightRule.birth, DayAndNightRule.survival>());
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// calls visit with the kernel for the rule: a compile time specialization for the common rules
+// so the inner loops carry no rule lookup, the compiled circuit for the rest
+template<typename Visitor>
+void VisitRuleKernel(const Rule& rule, Visitor&& visit) {
+    if (!VisitFixedRuleKernel(rule, visit)) {
+        visit(CircuitRuleKernel{CompileRuleCircuit(rule)});
+    }
+}
+
+#endif //GAME_OF_LIFE_BIT_KERNEL_H
@@ -0,0 +1,40 @@
+#ifndef GAME_OF_LIFE_BITS_H
+#define GAME_OF_LIFE_BITS_H
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+inline int PopCount(std::uint64_t value) {
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(value));
+#else
+    return __builtin_popcountll(value);
+#endif
+}
+
+// index of the lowest set bit, value must not be zero
+inline int CountTrailingZeros(std::uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+// number of clear bits above the highest set bit, value must not be zero
+inline int CountLeadingZeros(std::uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return 63 - static_cast<int>(index);
+#else
+    return __builtin_clzll(value);
+#endif
+}
+
+#endif //GAME_OF_LIFE_BITS_H
@@ -0,0 +1,65 @@
+#include "bitwise_engine.h"
+#include "bit_kernel.h"
+
+namespace {
+
+template<typename Kernel>
+void stepRows(const Board& current, Board& next, const Kernel& nextState) {
+    int height = current.GetHeight();
+    int wordsPerRow = current.GetWordsPerRow();
+
+    for (int y = 0; y < height; y++) {
+        StepRowWords(nextState, current.GetRow(y - 1), current.GetRow(y), current.GetRow(y + 1), next.GetRow(y),
+                     wordsPerRow);
+    }
+}
+
+}
+
+BitwiseEngine::BitwiseEngine(const Rule& rule) : Engine(rule) {
+}
+
+const char* BitwiseEngine::GetName() const {
+    return "bitwise";
+}
+
+void BitwiseEngine::Step(const Board& current, Board& next) {
+    if (m_rule.states > 2) {
+        stepGenerations(current, next);
+        return;
+    }
+
+    VisitRuleKernel(m_rule, [&](const auto& kernel) {
+        stepRows(current, next, kernel);
+    });
+
+    next.RefreshHalo();
+}
+
+void BitwiseEngine::stepGenerations(const Board& current, Board& next) {
+    int height = current.GetHeight();
+    int wordsPerRow = current.GetWordsPerRow();
+
+    // dying cells are dead to the neighbour count, the kernel sees only the live ones, the
+    // ghost rows and cells included
+    if (m_alive.GetWidth() != current.GetWidth() || m_alive.GetHeight() != height) {
+        m_alive = Board(current.GetWidth(), height);
+    }
+    for (int y = -1; y <= height; y++) {
+        std::uint64_t* row = m_alive.GetRow(y);
+        for (int w = 0; w < wordsPerRow; w++) {
+            row[w] = current.GetAliveWord(y, w);
+        }
+    }
+    m_nextAlive.resize(wordsPerRow);
+
+    VisitRuleKernel(GetTwoStateRule(m_rule), [&](const auto& kernel) {
+        for (int y = 0; y < height; y++) {
+            StepRowWords(kernel, m_alive.GetRow(y - 1), m_alive.GetRow(y), m_alive.GetRow(y + 1),
+                         m_nextAlive.data(), wordsPerRow);
+            StepGenerationsRow(current, next, y, m_nextAlive.data(), m_rule.states);
+        }
+    });
+
+    next.RefreshHalo();
+}
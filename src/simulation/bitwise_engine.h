@@ -0,0 +1,28 @@
+#ifndef GAME_OF_LIFE_BITWISE_ENGINE_H
+#define GAME_OF_LIFE_BITWISE_ENGINE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "engine.h"
+
+// Steps 64 cells per instruction with a bit-sliced adder network.
+//
+// Generations rules run the same kernel on the live cells and then advance the dying cells
+// with a bit-sliced increment over the state planes.
+class BitwiseEngine : public Engine {
+public:
+    explicit BitwiseEngine(const Rule& rule);
+
+    const char* GetName() const override;
+    void Step(const Board& current, Board& next) override;
+
+private:
+    void stepGenerations(const Board& current, Board& next);
+
+    // live cells of the current generation and the next live cells of one row, Generations only
+    Board m_alive;
+    std::vector<std::uint64_t> m_nextAlive;
+};
+
+#endif //GAME_OF_LIFE_BITWISE_ENGINE_H
@@ -0,0 +1,267 @@
+#include <algorithm>
+
+#include "board.h"
+#include "bits.h"
+
+namespace {
+
+std::uint64_t splitMix64(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+const char* const topologyNames[] = {"bounded", "torus", "klein"};
+
+// cell x of a row is bit x + 1, -1 and the width are the ghost cells
+bool getCell(const std::uint64_t* row, int x) {
+    int bit = x + 1;
+    return (row[bit / 64] >> (bit % 64)) & 1;
+}
+
+void setCell(std::uint64_t* row, int x, bool alive) {
+    int bit = x + 1;
+    std::uint64_t mask = std::uint64_t(1) << (bit % 64);
+    row[bit / 64] = alive ? row[bit / 64] | mask : row[bit / 64] & ~mask;
+}
+
+}
+
+const char* GetTopologyName(Topology topology) {
+    return topologyNames[static_cast<int>(topology)];
+}
+
+bool ParseTopology(const std::string& name, Topology& topology) {
+    for (int i = 0; i < 3; i++) {
+        if (name == topologyNames[i]) {
+            topology = static_cast<Topology>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WrapRow(Topology topology, int height, int& y, bool& mirrored) {
+    mirrored = false;
+    if (y >= 0 && y < height) {
+        return true;
+    }
+    if (topology == Topology::Bounded || height == 0) {
+        return false;
+    }
+
+    // how many times the row wraps around, rounded towards minus infinity
+    int turns = y >= 0 ? y / height : -((-y + height - 1) / height);
+    y -= turns * height;
+    mirrored = topology == Topology::KleinBottle && turns % 2 != 0;
+    return true;
+}
+
+Board::Board() : Board(0, 0) {
+}
+
+Board::Board(int width, int height, int planeCount)
+        : m_width(width), m_height(height),
+          m_wordsPerRow((width + 2 + 63) / 64),
+          m_stride(m_wordsPerRow + 2),
+          m_planeCount(planeCount),
+          m_topology(Topology::Bounded),
+          m_words(static_cast<size_t>(m_stride) * (height + 2) * planeCount, 0) {
+}
+
+int Board::GetWidth() const {
+    return m_width;
+}
+
+int Board::GetHeight() const {
+    return m_height;
+}
+
+int Board::GetPlaneCount() const {
+    return m_planeCount;
+}
+
+void Board::SetPlaneCount(int planeCount) {
+    m_planeCount = planeCount;
+    m_words.resize(static_cast<size_t>(m_stride) * (m_height + 2) * planeCount, 0);
+}
+
+Topology Board::GetTopology() const {
+    return m_topology;
+}
+
+void Board::SetTopology(Topology topology) {
+    m_topology = topology;
+}
+
+bool Board::Get(int x, int y) const {
+    int bit = x + 1;
+    if (m_planeCount == 1) {
+        return (GetRow(y)[bit / 64] >> (bit % 64)) & 1;
+    }
+    return (GetAliveWord(y, bit / 64) >> (bit % 64)) & 1;
+}
+
+void Board::Set(int x, int y, bool alive) {
+    SetState(x, y, alive ? 1 : 0);
+}
+
+int Board::GetState(int x, int y) const {
+    int bit = x + 1;
+    int state = 0;
+    for (int plane = 0; plane < m_planeCount; plane++) {
+        state |= static_cast<int>((GetRow(y, plane)[bit / 64] >> (bit % 64)) & 1) << plane;
+    }
+    return state;
+}
+
+void Board::SetState(int x, int y, int state) {
+    int bit = x + 1;
+    std::uint64_t mask = std::uint64_t(1) << (bit % 64);
+    for (int plane = 0; plane < m_planeCount; plane++) {
+        std::uint64_t& word = GetRow(y, plane)[bit / 64];
+        word = ((state >> plane) & 1) ? word | mask : word & ~mask;
+    }
+}
+
+void Board::Clear() {
+    std::fill(m_words.begin(), m_words.end(), 0);
+}
+
+void Board::Randomize(std::uint64_t seed, float density) {
+    std::fill(m_words.begin() + static_cast<std::ptrdiff_t>(m_stride) * (m_height + 2), m_words.end(), 0);
+
+    std::uint64_t state = seed;
+    auto threshold = static_cast<std::uint64_t>(static_cast<double>(density) * 18446744073709551615.0);
+
+    for (int y = 0; y < m_height; y++) {
+        std::uint64_t* row = GetRow(y);
+        for (int w = 0; w < m_wordsPerRow; w++) {
+            std::uint64_t word = 0;
+            if (density == .5f) {
+                word = splitMix64(state);
+            } else {
+                for (int bit = 0; bit < 64; bit++) {
+                    if (splitMix64(state) < threshold) {
+                        word |= std::uint64_t(1) << bit;
+                    }
+                }
+            }
+            row[w] = word & GetInteriorMask(w);
+        }
+    }
+}
+
+std::uint64_t Board::GetPopulation() const {
+    std::uint64_t population = 0;
+    for (int y = 0; y < m_height; y++) {
+        const std::uint64_t* row = GetRow(y);
+        for (int w = 0; w < m_wordsPerRow; w++) {
+            population += PopCount((m_planeCount == 1 ? row[w] : GetAliveWord(y, w)) & GetInteriorMask(w));
+        }
+    }
+    return population;
+}
+
+int Board::GetWordsPerRow() const {
+    return m_wordsPerRow;
+}
+
+const std::uint64_t* Board::GetRow(int y, int plane) const {
+    return m_words.data() + (static_cast<size_t>(plane) * (m_height + 2) + y + 1) * m_stride + 1;
+}
+
+std::uint64_t* Board::GetRow(int y, int plane) {
+    return m_words.data() + (static_cast<size_t>(plane) * (m_height + 2) + y + 1) * m_stride + 1;
+}
+
+std::uint64_t Board::GetAliveWord(int y, int word) const {
+    std::uint64_t higher = 0;
+    for (int plane = 1; plane < m_planeCount; plane++) {
+        higher |= GetRow(y, plane)[word];
+    }
+    return GetRow(y)[word] & ~higher;
+}
+
+std::uint64_t Board::GetInteriorMask(int word) const {
+    // interior cells occupy bits [1, width] of the padded row
+    int first = std::max(1, word * 64);
+    int last = std::min(m_width, word * 64 + 63);
+    if (first > last) {
+        return 0;
+    }
+
+    int low = first - word * 64;
+    int count = last - first + 1;
+    std::uint64_t mask = count == 64 ? ~std::uint64_t(0) : ((std::uint64_t(1) << count) - 1);
+    return mask << low;
+}
+
+void Board::RefreshHalo() {
+    std::uint64_t firstMask = GetInteriorMask(0);
+    for (int plane = 0; plane < m_planeCount; plane++) {
+        // only the first word and the trailing words of a row contain ghost or unused bits
+        for (int y = 0; y < m_height; y++) {
+            std::uint64_t* row = GetRow(y, plane);
+            row[0] &= firstMask;
+            for (int w = std::max(1, m_width / 64); w < m_wordsPerRow; w++) {
+                row[w] &= GetInteriorMask(w);
+            }
+        }
+
+        std::uint64_t* above = GetRow(-1, plane);
+        std::uint64_t* below = GetRow(m_height, plane);
+        if (m_topology == Topology::Bounded || m_width == 0 || m_height == 0) {
+            std::fill(above - 1, above + m_stride - 1, 0);
+            std::fill(below - 1, below + m_stride - 1, 0);
+            continue;
+        }
+
+        // the ghost cells of every row are the cells at the other end, then the ghost rows are
+        // the rows at the other end together with their ghost cells, which fills the corners
+        for (int y = 0; y < m_height; y++) {
+            std::uint64_t* row = GetRow(y, plane);
+            setCell(row, -1, getCell(row, m_width - 1));
+            setCell(row, m_width, getCell(row, 0));
+        }
+
+        const std::uint64_t* first = GetRow(0, plane);
+        const std::uint64_t* last = GetRow(m_height - 1, plane);
+        if (m_topology == Topology::Torus) {
+            std::copy(last, last + m_wordsPerRow, above);
+            std::copy(first, first + m_wordsPerRow, below);
+        } else {
+            // mirrored, cell x of the ghost row is cell width - 1 - x of the row it stands for
+            std::fill(above, above + m_wordsPerRow, 0);
+            std::fill(below, below + m_wordsPerRow, 0);
+            for (int x = -1; x <= m_width; x++) {
+                setCell(above, x, getCell(last, m_width - 1 - x));
+                setCell(below, x, getCell(first, m_width - 1 - x));
+            }
+        }
+    }
+}
+
+bool Board::operator==(const Board& other) const {
+    if (m_width != other.m_width || m_height != other.m_height || m_planeCount != other.m_planeCount) {
+        return false;
+    }
+
+    for (int plane = 0; plane < m_planeCount; plane++) {
+        for (int y = 0; y < m_height; y++) {
+            const std::uint64_t* row = GetRow(y, plane);
+            const std::uint64_t* otherRow = other.GetRow(y, plane);
+            for (int w = 0; w < m_wordsPerRow; w++) {
+                if ((row[w] ^ otherRow[w]) & GetInteriorMask(w)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool Board::operator!=(const Board& other) const {
+    return !(*this == other);
+}
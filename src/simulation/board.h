@@ -0,0 +1,92 @@
+#ifndef GAME_OF_LIFE_BOARD_H
+#define GAME_OF_LIFE_BOARD_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// What lies beyond the edges of a board. Bounded boards are surrounded by dead cells, a torus
+// wraps both axes around and a Klein bottle wraps like a torus but mirrors the columns when it
+// wraps across the top or bottom edge.
+enum class Topology {
+    Bounded,
+    Torus,
+    KleinBottle
+};
+
+// "bounded", "torus" or "klein"
+const char* GetTopologyName(Topology topology);
+bool ParseTopology(const std::string& name, Topology& topology);
+
+// the row of a board of the height that row y beyond the edges stands for, and whether its
+// columns are mirrored; false for the dead rows around bounded boards
+bool WrapRow(Topology topology, int height, int& y, bool& mirrored);
+
+// Bit-packed field of cells, one bit per cell.
+//
+// Every row is stored with a one cell halo: cell x lives at bit x + 1 of the row, bit 0 of the
+// first word and bit width + 1 are ghost cells. Each row is also padded with one zero word on
+// both sides, and there is one ghost row above and below the field, so step kernels can read
+// the neighbouring words and rows of any cell without bounds checks.
+//
+// The halo follows the topology of the board: RefreshHalo fills it with dead cells or with copies
+// of the opposite edges, so kernels that read the halo step any topology without a branch.
+//
+// Multi-state boards (Generations rules) keep the state of a cell in binary over several planes
+// of that layout, bit k in plane k; state 1 is alive, 0 dead and the others dying. Two-state
+// boards have just the plane of live cells.
+class Board {
+public:
+    Board();
+    Board(int width, int height, int planeCount = 1);
+
+    int GetWidth() const;
+    int GetHeight() const;
+    int GetPlaneCount() const;
+    // added planes start out clear, removing planes drops the high bits of the states
+    void SetPlaneCount(int planeCount);
+    // takes effect on the next RefreshHalo
+    Topology GetTopology() const;
+    void SetTopology(Topology topology);
+
+    // alive means state 1
+    bool Get(int x, int y) const;
+    void Set(int x, int y, bool alive);
+    int GetState(int x, int y) const;
+    void SetState(int x, int y, int state);
+
+    void Clear();
+    // live cells with the given density, every other cell dead
+    void Randomize(std::uint64_t seed, float density);
+
+    // live cells only, dying ones are not counted
+    std::uint64_t GetPopulation() const;
+
+    // raw access for the step kernels, y is in [-1, height]
+    int GetWordsPerRow() const;
+    const std::uint64_t* GetRow(int y, int plane = 0) const;
+    std::uint64_t* GetRow(int y, int plane = 0);
+    // the live cells of a word of a row, plane 0 without the dying cells of multi-state boards
+    std::uint64_t GetAliveWord(int y, int word) const;
+
+    // bits of the word that belong to the field itself (no ghost or unused bits)
+    std::uint64_t GetInteriorMask(int word) const;
+
+    // restores the halo after a kernel has written the rows: unused bits are cleared and the ghost
+    // cells are dead or copies of the cells they stand for, O(width + height)
+    void RefreshHalo();
+
+    bool operator==(const Board& other) const;
+    bool operator!=(const Board& other) const;
+
+private:
+    int m_width;
+    int m_height;
+    int m_wordsPerRow;
+    int m_stride;
+    int m_planeCount;
+    Topology m_topology;
+    std::vector<std::uint64_t> m_words;
+};
+
+#endif //GAME_OF_LIFE_BOARD_H
@@ -0,0 +1,173 @@
+#include <algorithm>
+
+#include "board_batch.h"
+#include "bits.h"
+
+namespace {
+
+std::uint64_t splitMix64(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+}
+
+BoardBatch::BoardBatch() : BoardBatch(0, 0, 0) {
+}
+
+BoardBatch::BoardBatch(int width, int height, int boardCount)
+        : m_width(width), m_height(height), m_boardCount(boardCount),
+          m_laneWords((boardCount + 63) / 64),
+          m_rowWords((width + 2) * m_laneWords),
+          m_topology(Topology::Bounded),
+          m_words(static_cast<size_t>(m_rowWords) * (height + 2), 0) {
+}
+
+int BoardBatch::GetWidth() const {
+    return m_width;
+}
+
+int BoardBatch::GetHeight() const {
+    return m_height;
+}
+
+int BoardBatch::GetBoardCount() const {
+    return m_boardCount;
+}
+
+int BoardBatch::GetLaneWords() const {
+    return m_laneWords;
+}
+
+Topology BoardBatch::GetTopology() const {
+    return m_topology;
+}
+
+void BoardBatch::SetTopology(Topology topology) {
+    m_topology = topology;
+}
+
+bool BoardBatch::Get(int board, int x, int y) const {
+    return (GetCell(x, y)[board / 64] >> (board % 64)) & 1;
+}
+
+void BoardBatch::Set(int board, int x, int y, bool alive) {
+    std::uint64_t& word = GetCell(x, y)[board / 64];
+    std::uint64_t mask = std::uint64_t(1) << (board % 64);
+    word = alive ? word | mask : word & ~mask;
+}
+
+void BoardBatch::SetBoard(int board, const Board& cells) {
+    for (int y = 0; y < m_height; y++) {
+        for (int x = 0; x < m_width; x++) {
+            Set(board, x, y, cells.Get(x, y));
+        }
+    }
+}
+
+Board BoardBatch::GetBoard(int board) const {
+    Board cells(m_width, m_height);
+    cells.SetTopology(m_topology);
+    for (int y = 0; y < m_height; y++) {
+        for (int x = 0; x < m_width; x++) {
+            cells.SetState(x, y, Get(board, x, y));
+        }
+    }
+    cells.RefreshHalo();
+    return cells;
+}
+
+void BoardBatch::Randomize(std::uint64_t seed, float density) {
+    std::uint64_t state = seed;
+    auto threshold = static_cast<std::uint64_t>(static_cast<double>(density) * 18446744073709551615.0);
+    for (int y = 0; y < m_height; y++) {
+        for (int x = 0; x < m_width; x++) {
+            std::uint64_t* cell = GetCell(x, y);
+            for (int w = 0; w < m_laneWords; w++) {
+                std::uint64_t word = 0;
+                if (density == .5f) {
+                    word = splitMix64(state);
+                } else {
+                    for (int bit = 0; bit < 64; bit++) {
+                        if (splitMix64(state) < threshold) {
+                            word |= std::uint64_t(1) << bit;
+                        }
+                    }
+                }
+                cell[w] = word;
+            }
+        }
+    }
+}
+
+std::vector<std::uint64_t> BoardBatch::GetPopulations() const {
+    // bit-sliced counters: word w of plane k holds bit k of the populations of boards 64 * w to
+    // 64 * w + 63, every cell is added with a ripple carry that rarely goes past the first planes
+    int planes = 1;
+    while ((std::int64_t(1) << planes) <= static_cast<std::int64_t>(m_width) * m_height) {
+        planes++;
+    }
+    std::vector<std::uint64_t> counters(static_cast<size_t>(planes) * m_laneWords, 0);
+    for (int y = 0; y < m_height; y++) {
+        for (int x = 0; x < m_width; x++) {
+            const std::uint64_t* cell = GetCell(x, y);
+            for (int w = 0; w < m_laneWords; w++) {
+                std::uint64_t carry = cell[w];
+                for (std::uint64_t* counter = counters.data() + w; carry != 0; counter += m_laneWords) {
+                    std::uint64_t overflow = *counter & carry;
+                    *counter ^= carry;
+                    carry = overflow;
+                }
+            }
+        }
+    }
+
+    std::vector<std::uint64_t> populations(m_boardCount, 0);
+    for (int board = 0; board < m_boardCount; board++) {
+        for (int plane = 0; plane < planes; plane++) {
+            std::uint64_t bit = (counters[static_cast<size_t>(plane) * m_laneWords + board / 64] >> (board % 64)) & 1;
+            populations[board] |= bit << plane;
+        }
+    }
+    return populations;
+}
+
+const std::uint64_t* BoardBatch::GetCell(int x, int y) const {
+    return m_words.data() + static_cast<size_t>(y + 1) * m_rowWords + static_cast<size_t>(x + 1) * m_laneWords;
+}
+
+std::uint64_t* BoardBatch::GetCell(int x, int y) {
+    return m_words.data() + static_cast<size_t>(y + 1) * m_rowWords + static_cast<size_t>(x + 1) * m_laneWords;
+}
+
+void BoardBatch::RefreshHalo() {
+    std::uint64_t* above = GetCell(-1, -1);
+    std::uint64_t* below = GetCell(-1, m_height);
+    if (m_topology == Topology::Bounded || m_width == 0 || m_height == 0) {
+        std::fill(above, above + m_rowWords, 0);
+        std::fill(below, below + m_rowWords, 0);
+        for (int y = 0; y < m_height; y++) {
+            std::fill(GetCell(-1, y), GetCell(0, y), 0);
+            std::fill(GetCell(m_width, y), GetCell(m_width + 1, y), 0);
+        }
+        return;
+    }
+
+    // as Board::RefreshHalo: the ghost cells of every row first, then the ghost rows with them
+    for (int y = 0; y < m_height; y++) {
+        std::copy(GetCell(m_width - 1, y), GetCell(m_width, y), GetCell(-1, y));
+        std::copy(GetCell(0, y), GetCell(1, y), GetCell(m_width, y));
+    }
+    if (m_topology == Topology::Torus) {
+        std::copy(GetCell(-1, m_height - 1), GetCell(-1, m_height), above);
+        std::copy(GetCell(-1, 0), GetCell(-1, 1), below);
+    } else {
+        // mirrored, cell x of the ghost row is cell width - 1 - x of the row it stands for
+        for (int x = -1; x <= m_width; x++) {
+            std::copy(GetCell(m_width - 1 - x, m_height - 1), GetCell(m_width - x, m_height - 1), GetCell(x, -1));
+            std::copy(GetCell(m_width - 1 - x, 0), GetCell(m_width - x, 0), GetCell(x, m_height));
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef GAME_OF_LIFE_BOARD_BATCH_H
+#define GAME_OF_LIFE_BOARD_BATCH_H
+
+#include <cstdint>
+#include <vector>
+
+#include "board.h"
+
+// Many independent boards of the same size stored transposed, so that one kernel steps all of
+// them at once: the cells (x, y) of every board are GetLaneWords() consecutive words, bit b of
+// word w belongs to board 64 * w + b. A step then works on whole words without shifts, and the
+// words of a row are contiguous, so the loops fill every vector register whatever the width of
+// the boards.
+//
+// As with Board, the boards have a one cell halo that RefreshHalo fills for the topology.
+class BoardBatch {
+public:
+    BoardBatch();
+    // storage is rounded up to a multiple of 64 boards, the bits past the board count are
+    // stepped like the others and ignored
+    BoardBatch(int width, int height, int boardCount);
+
+    int GetWidth() const;
+    int GetHeight() const;
+    int GetBoardCount() const;
+    int GetLaneWords() const;
+    // takes effect on the next RefreshHalo
+    Topology GetTopology() const;
+    void SetTopology(Topology topology);
+
+    bool Get(int board, int x, int y) const;
+    void Set(int board, int x, int y, bool alive);
+    // copy one board of the batch's size in and out
+    void SetBoard(int board, const Board& cells);
+    Board GetBoard(int board) const;
+    // every board gets a soup of its own
+    void Randomize(std::uint64_t seed, float density);
+    std::vector<std::uint64_t> GetPopulations() const;
+
+    // the lane words of cell x of row y, both from -1 to the width and height
+    const std::uint64_t* GetCell(int x, int y) const;
+    std::uint64_t* GetCell(int x, int y);
+
+    // fills the ghost cells with dead cells or the cells they stand for
+    void RefreshHalo();
+
+private:
+    int m_width;
+    int m_height;
+    int m_boardCount;
+    int m_laneWords;
+    // words from one row to the next, the ghost cells included
+    int m_rowWords;
+    Topology m_topology;
+    std::vector<std::uint64_t> m_words;
+};
+
+#endif //GAME_OF_LIFE_BOARD_BATCH_H
@@ -0,0 +1,137 @@
+#include <algorithm>
+
+#include "board_delta.h"
+#include "bits.h"
+
+BoardDelta::BoardDelta() : m_tiles(), m_rowMasks(), m_words() {
+}
+
+BoardDelta BoardDelta::Between(const Board& from, const Board& to) {
+    BoardDelta delta;
+    int wordsPerRow = from.GetWordsPerRow();
+    int tileRowCount = (from.GetHeight() + TileRows - 1) / TileRows;
+    std::vector<std::uint64_t> rowMasks(wordsPerRow);
+
+    // the state planes of multi-state boards follow each other as further bands of tiles
+    for (int band = 0; band < tileRowCount * from.GetPlaneCount(); band++) {
+        int plane = band / tileRowCount;
+        int firstRow = band % tileRowCount * TileRows;
+        int rows = std::min(TileRows, from.GetHeight() - firstRow);
+
+        // find the changed rows of every tile in the band walking the memory in order
+        std::fill(rowMasks.begin(), rowMasks.end(), 0);
+        for (int r = 0; r < rows; r++) {
+            const std::uint64_t* fromRow = from.GetRow(firstRow + r, plane);
+            const std::uint64_t* toRow = to.GetRow(firstRow + r, plane);
+            for (int w = 0; w < wordsPerRow; w++) {
+                if ((fromRow[w] ^ toRow[w]) & from.GetInteriorMask(w)) {
+                    rowMasks[w] |= std::uint64_t(1) << r;
+                }
+            }
+        }
+
+        for (int w = 0; w < wordsPerRow; w++) {
+            std::uint64_t rowMask = rowMasks[w];
+            if (rowMask == 0) {
+                continue;
+            }
+
+            delta.m_tiles.push_back(static_cast<std::uint32_t>(band * wordsPerRow + w));
+            delta.m_rowMasks.push_back(rowMask);
+            while (rowMask != 0) {
+                int r = firstRow + CountTrailingZeros(rowMask);
+                rowMask &= rowMask - 1;
+                delta.m_words.push_back((from.GetRow(r, plane)[w] ^ to.GetRow(r, plane)[w]) & from.GetInteriorMask(w));
+            }
+        }
+    }
+
+    delta.m_tiles.shrink_to_fit();
+    delta.m_rowMasks.shrink_to_fit();
+    delta.m_words.shrink_to_fit();
+    return delta;
+}
+
+void BoardDelta::ApplyTo(Board& board) const {
+    int wordsPerRow = board.GetWordsPerRow();
+    int tileRowCount = (board.GetHeight() + TileRows - 1) / TileRows;
+    size_t word = 0;
+    for (size_t i = 0; i < m_tiles.size(); i++) {
+        int band = static_cast<int>(m_tiles[i] / wordsPerRow);
+        int plane = band / tileRowCount;
+        int firstRow = band % tileRowCount * TileRows;
+        int w = static_cast<int>(m_tiles[i] % wordsPerRow);
+
+        std::uint64_t rowMask = m_rowMasks[i];
+        while (rowMask != 0) {
+            int r = firstRow + CountTrailingZeros(rowMask);
+            rowMask &= rowMask - 1;
+            board.GetRow(r, plane)[w] ^= m_words[word++];
+        }
+    }
+}
+
+bool BoardDelta::Fits(const Board& board) const {
+    int tileRowCount = (board.GetHeight() + TileRows - 1) / TileRows;
+    std::uint64_t tileCount = static_cast<std::uint64_t>(tileRowCount) * board.GetPlaneCount() * board.GetWordsPerRow();
+    for (size_t i = 0; i < m_tiles.size(); i++) {
+        int firstRow = static_cast<int>(m_tiles[i] / board.GetWordsPerRow() % std::max(1, tileRowCount)) * TileRows;
+        // rows past the last one of the last band
+        if (m_tiles[i] >= tileCount || (firstRow + TileRows > board.GetHeight()
+                                        && (m_rowMasks[i] >> (board.GetHeight() - firstRow)) != 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BoardDelta::IsEmpty() const {
+    return m_tiles.empty();
+}
+
+size_t BoardDelta::GetTileCount() const {
+    return m_tiles.size();
+}
+
+size_t BoardDelta::GetByteSize() const {
+    return sizeof(BoardDelta) + m_tiles.capacity() * sizeof(std::uint32_t)
+           + (m_rowMasks.capacity() + m_words.capacity()) * sizeof(std::uint64_t);
+}
+
+void BoardDelta::Write(std::ostream& stream) const {
+    auto tileCount = static_cast<std::uint32_t>(m_tiles.size());
+    stream.write(reinterpret_cast<const char*>(&tileCount), sizeof(tileCount));
+    stream.write(reinterpret_cast<const char*>(m_tiles.data()),
+                 static_cast<std::streamsize>(m_tiles.size() * sizeof(std::uint32_t)));
+    stream.write(reinterpret_cast<const char*>(m_rowMasks.data()),
+                 static_cast<std::streamsize>(m_rowMasks.size() * sizeof(std::uint64_t)));
+    stream.write(reinterpret_cast<const char*>(m_words.data()),
+                 static_cast<std::streamsize>(m_words.size() * sizeof(std::uint64_t)));
+}
+
+bool BoardDelta::Read(std::istream& stream) {
+    std::uint32_t tileCount = 0;
+    stream.read(reinterpret_cast<char*>(&tileCount), sizeof(tileCount));
+    if (!stream) {
+        return false;
+    }
+
+    m_tiles.resize(tileCount);
+    m_rowMasks.resize(tileCount);
+    stream.read(reinterpret_cast<char*>(m_tiles.data()),
+                static_cast<std::streamsize>(m_tiles.size() * sizeof(std::uint32_t)));
+    stream.read(reinterpret_cast<char*>(m_rowMasks.data()),
+                static_cast<std::streamsize>(m_rowMasks.size() * sizeof(std::uint64_t)));
+    if (!stream) {
+        return false;
+    }
+
+    size_t wordCount = 0;
+    for (std::uint64_t rowMask : m_rowMasks) {
+        wordCount += PopCount(rowMask);
+    }
+    m_words.resize(wordCount);
+    stream.read(reinterpret_cast<char*>(m_words.data()),
+                static_cast<std::streamsize>(m_words.size() * sizeof(std::uint64_t)));
+    return static_cast<bool>(stream);
+}
@@ -0,0 +1,42 @@
+#ifndef GAME_OF_LIFE_BOARD_DELTA_H
+#define GAME_OF_LIFE_BOARD_DELTA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "board.h"
+
+// Difference between two boards of the same size as XOR words of the changed tiles.
+// A tile is one word column (64 cells) of 64 rows of one state plane; only the rows that changed are stored.
+// XOR makes the delta symmetric: applying it to either board yields the other one.
+class BoardDelta {
+public:
+    static constexpr int TileRows = 64;
+
+    BoardDelta();
+
+    static BoardDelta Between(const Board& from, const Board& to);
+
+    // O(changed tiles), the board must have the size the delta was computed for
+    void ApplyTo(Board& board) const;
+    // whether every tile lies within the board, for deltas read from files
+    bool Fits(const Board& board) const;
+
+    bool IsEmpty() const;
+    size_t GetTileCount() const;
+    // memory held by the delta, for history budgets
+    size_t GetByteSize() const;
+
+    void Write(std::ostream& stream) const;
+    bool Read(std::istream& stream);
+
+private:
+    std::vector<std::uint32_t> m_tiles;
+    std::vector<std::uint64_t> m_rowMasks;
+    std::vector<std::uint64_t> m_words;
+};
+
+#endif //GAME_OF_LIFE_BOARD_DELTA_H
@@ -0,0 +1,107 @@
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+#include "board_io.h"
+
+namespace {
+
+const char boardMagic[4] = {'G', 'O', 'L', 'B'};
+const std::uint32_t boardVersion = 2;
+// headers of version 1 files stop before the plane count
+const size_t boardHeaderV1Size = offsetof(BoardFileHeader, planeCount);
+const int maxPlaneCount = 8;
+
+}
+
+BoardFileHeader MakeBoardFileHeader(const Board& board, std::uint64_t generation) {
+    BoardFileHeader header{};
+    std::memcpy(header.magic, boardMagic, sizeof(boardMagic));
+    header.version = boardVersion;
+    header.width = board.GetWidth();
+    header.height = board.GetHeight();
+    header.generation = generation;
+    header.planeCount = static_cast<std::uint32_t>(board.GetPlaneCount());
+    header.topology = static_cast<std::uint32_t>(board.GetTopology());
+    return header;
+}
+
+bool WriteBoard(std::ostream& stream, const Board& board, std::uint64_t generation) {
+    BoardFileHeader header = MakeBoardFileHeader(board, generation);
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    auto rowBytes = static_cast<std::streamsize>(sizeof(std::uint64_t) * board.GetWordsPerRow());
+    for (int plane = 0; plane < board.GetPlaneCount(); plane++) {
+        for (int y = 0; y < board.GetHeight(); y++) {
+            stream.write(reinterpret_cast<const char*>(board.GetRow(y, plane)), rowBytes);
+        }
+    }
+    return static_cast<bool>(stream);
+}
+
+bool ReadBoard(std::istream& stream, Board& board, std::uint64_t& generation) {
+    BoardFileHeader header{};
+    header.planeCount = 1;
+    stream.read(reinterpret_cast<char*>(&header), boardHeaderV1Size);
+    if (stream && header.version == boardVersion) {
+        stream.read(reinterpret_cast<char*>(&header) + boardHeaderV1Size, sizeof(header) - boardHeaderV1Size);
+    }
+    if (!stream || std::memcmp(header.magic, boardMagic, sizeof(boardMagic)) != 0
+        || header.version < 1 || header.version > boardVersion || header.width < 0 || header.height < 0
+        || header.planeCount < 1 || header.planeCount > maxPlaneCount
+        || header.topology > static_cast<std::uint32_t>(Topology::KleinBottle)) {
+        std::cout << "ERROR::BOARD: Not a board file" << std::endl;
+        return false;
+    }
+
+    Board result(header.width, header.height, static_cast<int>(header.planeCount));
+    auto rowBytes = static_cast<std::streamsize>(sizeof(std::uint64_t) * result.GetWordsPerRow());
+    for (int plane = 0; plane < result.GetPlaneCount(); plane++) {
+        for (int y = 0; y < result.GetHeight(); y++) {
+            stream.read(reinterpret_cast<char*>(result.GetRow(y, plane)), rowBytes);
+        }
+    }
+    if (!stream) {
+        std::cout << "ERROR::BOARD: Truncated board file" << std::endl;
+        return false;
+    }
+
+    result.SetTopology(static_cast<Topology>(header.topology));
+    result.RefreshHalo();
+    board = std::move(result);
+    generation = header.generation;
+    return true;
+}
+
+bool SaveBoard(const std::string& path, const Board& board, std::uint64_t generation) {
+    std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file || !WriteBoard(file, board, generation)) {
+            std::cout << "ERROR::BOARD: Failed to write " << temporaryPath << std::endl;
+            return false;
+        }
+    }
+
+#if defined(_WIN32)
+    // rename does not replace an existing file on windows
+    std::remove(path.c_str());
+#endif
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        std::cout << "ERROR::BOARD: Failed to rename " << temporaryPath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool LoadBoard(const std::string& path, Board& board, std::uint64_t& generation) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cout << "ERROR::BOARD: Failed to open " << path << std::endl;
+        return false;
+    }
+    return ReadBoard(file, board, generation);
+}
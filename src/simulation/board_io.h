@@ -0,0 +1,34 @@
+#ifndef GAME_OF_LIFE_BOARD_IO_H
+#define GAME_OF_LIFE_BOARD_IO_H
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+
+#include "board.h"
+
+// Binary board file: this header followed by GetWordsPerRow() little endian words per row,
+// top to bottom, in the padded bit layout of Board, for each state plane in turn.
+// Version 1 files end the header before planeCount and always have one plane, boards written
+// before topologies were added have 0 there, which is bounded.
+struct BoardFileHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::int32_t width;
+    std::int32_t height;
+    std::uint64_t generation;
+    std::uint32_t planeCount;
+    std::uint32_t topology;
+};
+
+BoardFileHeader MakeBoardFileHeader(const Board& board, std::uint64_t generation);
+
+bool WriteBoard(std::ostream& stream, const Board& board, std::uint64_t generation);
+bool ReadBoard(std::istream& stream, Board& board, std::uint64_t& generation);
+
+// writes to a temporary file first so that a crash never leaves a truncated board behind
+bool SaveBoard(const std::string& path, const Board& board, std::uint64_t generation);
+bool LoadBoard(const std::string& path, Board& board, std::uint64_t& generation);
+
+#endif //GAME_OF_LIFE_BOARD_IO_H
@@ -0,0 +1,556 @@
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <memory>
+
+#include "census.h"
+#include "bits.h"
+#include "engine_registry.h"
+#include "../profiling/trace.h"
+
+namespace {
+
+using Cell = std::pair<int, int>;
+
+const char wechslerDigits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+std::uint64_t splitMix64(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+bool rowMajor(const Cell& left, const Cell& right) {
+    return left.second != right.second ? left.second < right.second : left.first < right.first;
+}
+
+// live cells of the board row by row
+std::vector<Cell> liveCells(const Board& board) {
+    std::vector<Cell> cells;
+    for (int y = 0; y < board.GetHeight(); y++) {
+        const std::uint64_t* row = board.GetRow(y);
+        for (int w = 0; w < board.GetWordsPerRow(); w++) {
+            std::uint64_t word = row[w] & board.GetInteriorMask(w);
+            while (word != 0) {
+                cells.emplace_back(w * 64 + CountTrailingZeros(word) - 1, y);
+                word &= word - 1;
+            }
+        }
+    }
+    return cells;
+}
+
+// moves the cells so that the least x and y are 0 and returns how far they were
+Cell normalize(std::vector<Cell>& cells) {
+    Cell origin(INT_MAX, INT_MAX);
+    for (const Cell& cell : cells) {
+        origin.first = std::min(origin.first, cell.first);
+        origin.second = std::min(origin.second, cell.second);
+    }
+    for (Cell& cell : cells) {
+        cell.first -= origin.first;
+        cell.second -= origin.second;
+    }
+    return cells.empty() ? Cell(0, 0) : origin;
+}
+
+// only the board's hash, the board itself is compared before a cycle is believed
+std::uint64_t boardHash(const Board& board) {
+    std::uint64_t hash = 0;
+    std::uint64_t salt = 0;
+    for (int y = 0; y < board.GetHeight(); y++) {
+        const std::uint64_t* row = board.GetRow(y);
+        for (int w = 0; w < board.GetWordsPerRow(); w++) {
+            hash += (row[w] ^ salt) * 0xBF58476D1CE4E5B9ull;
+            salt += 0x9E3779B97F4A7C15ull;
+        }
+    }
+    return hash;
+}
+
+// generations 0 to count of the cells on their own, row by row in the coordinates of the cells;
+// the board leaves room for growing at the speed of light on every side
+std::vector<std::vector<Cell>> evolve(Engine& engine, const std::vector<Cell>& cells, int count) {
+    if (cells.empty()) {
+        return std::vector<std::vector<Cell>>(static_cast<size_t>(count) + 1);
+    }
+
+    int minX = INT_MAX, minY = INT_MAX, maxX = INT_MIN, maxY = INT_MIN;
+    for (const Cell& cell : cells) {
+        minX = std::min(minX, cell.first);
+        minY = std::min(minY, cell.second);
+        maxX = std::max(maxX, cell.first);
+        maxY = std::max(maxY, cell.second);
+    }
+    int margin = count + 1;
+    Board current(maxX - minX + 1 + 2 * margin, maxY - minY + 1 + 2 * margin);
+    Board next(current.GetWidth(), current.GetHeight());
+    for (const Cell& cell : cells) {
+        current.Set(cell.first - minX + margin, cell.second - minY + margin, true);
+    }
+    current.RefreshHalo();
+
+    std::vector<std::vector<Cell>> generations;
+    for (int generation = 0;; generation++) {
+        generations.push_back(liveCells(current));
+        for (Cell& cell : generations.back()) {
+            cell.first += minX - margin;
+            cell.second += minY - margin;
+        }
+        if (generation == count) {
+            return generations;
+        }
+        engine.Step(current, next);
+        std::swap(current, next);
+    }
+}
+
+// one of the eight rotations and reflections of the square, normalized
+std::vector<Cell> transform(const std::vector<Cell>& cells, int symmetry) {
+    std::vector<Cell> result;
+    result.reserve(cells.size());
+    for (const Cell& cell : cells) {
+        int x = cell.first;
+        int y = cell.second;
+        if (symmetry & 4) {
+            std::swap(x, y);
+        }
+        result.emplace_back(symmetry & 1 ? -x : x, symmetry & 2 ? -y : y);
+    }
+    normalize(result);
+    return result;
+}
+
+// extended Wechsler code of normalized cells: strips of five rows separated by z, a digit per
+// column with the top row in the lowest bit, the zero columns at the end of a strip left out and
+// runs of zeros written as w for two, x for three and y and a digit for 4 to 39
+std::string wechsler(const std::vector<Cell>& cells) {
+    int width = 0;
+    int height = 0;
+    for (const Cell& cell : cells) {
+        width = std::max(width, cell.first + 1);
+        height = std::max(height, cell.second + 1);
+    }
+    int strips = (height + 4) / 5;
+    std::vector<int> columns(static_cast<size_t>(strips) * width, 0);
+    for (const Cell& cell : cells) {
+        columns[static_cast<size_t>(cell.second / 5) * width + cell.first] |= 1 << (cell.second % 5);
+    }
+
+    std::string code;
+    for (int strip = 0; strip < strips; strip++) {
+        const int* column = columns.data() + static_cast<size_t>(strip) * width;
+        if (strip > 0) {
+            code += 'z';
+        }
+        int length = width;
+        while (length > 0 && column[length - 1] == 0) {
+            length--;
+        }
+        for (int x = 0; x < length;) {
+            if (column[x] != 0) {
+                code += wechslerDigits[column[x++]];
+                continue;
+            }
+            int zeros = 0;
+            for (; x < length && column[x] == 0; x++) {
+                zeros++;
+            }
+            for (; zeros >= 4; zeros -= std::min(zeros, 39)) {
+                code += 'y';
+                code += wechslerDigits[std::min(zeros, 39) - 4];
+            }
+            code += zeros == 3 ? "x" : zeros == 2 ? "w" : zeros == 1 ? "0" : "";
+        }
+    }
+    return code;
+}
+
+// the shortest, then the least code of any phase in any orientation
+std::string canonicalCode(const std::vector<std::vector<Cell>>& phases) {
+    std::string best;
+    for (const std::vector<Cell>& phase : phases) {
+        for (int symmetry = 0; symmetry < 8; symmetry++) {
+            std::string code = wechsler(transform(phase, symmetry));
+            if (best.empty() || code.size() < best.size() || (code.size() == best.size() && code < best)) {
+                best = code;
+            }
+        }
+    }
+    return best;
+}
+
+// code of an object that repeats, in place or moved, within periodLimit generations
+std::string classify(Engine& engine, const std::vector<Cell>& cells, int periodLimit) {
+    std::vector<std::vector<Cell>> generations = evolve(engine, cells, periodLimit);
+    std::vector<Cell> first = generations[0];
+    Cell origin = normalize(first);
+    for (int period = 1; period <= periodLimit && !first.empty(); period++) {
+        std::vector<Cell> shape = generations[period];
+        Cell offset = normalize(shape);
+        if (shape != first) {
+            continue;
+        }
+
+        std::vector<std::vector<Cell>> phases(generations.begin(), generations.begin() + period);
+        if (offset != origin) {
+            return "xq" + std::to_string(period) + "_" + canonicalCode(phases);
+        }
+        if (period == 1) {
+            return "xs" + std::to_string(first.size()) + "_" + canonicalCode(phases);
+        }
+        return "xp" + std::to_string(period) + "_" + canonicalCode(phases);
+    }
+    return "zz_unidentified";
+}
+
+// Runs soups one after another on one thread, with the boards and scratch space of the last.
+class SoupRunner {
+public:
+    explicit SoupRunner(const CensusOptions& options);
+
+    SoupResult Run(const Board& soup);
+
+private:
+    bool touchesEdge() const;
+    void removeEscaping(std::vector<std::string>& objects);
+    // cells reachable from start through cells set in m_grid no more than reach apart, which are
+    // cleared
+    std::vector<Cell> flood(std::vector<std::uint8_t>& grid, Cell start, int reach) const;
+    // cells of the first phase of every object of the ash in m_phases, see Census
+    std::vector<std::vector<Cell>> separate();
+    bool runsAlone(const std::vector<Cell>& part);
+    std::vector<Cell> firstPhase(const std::vector<Cell>& cells) const;
+
+    const CensusOptions& m_options;
+    int m_size;
+    std::unique_ptr<Engine> m_engine;
+    Board m_current;
+    Board m_next;
+    // hashes of the last generations by generation modulo the maximum period + 1
+    std::vector<std::uint64_t> m_hashes;
+    // the generations of a cycle from its first
+    std::vector<Board> m_phases;
+    // one byte per cell for separating objects
+    std::vector<std::uint8_t> m_grid;
+    std::vector<std::uint8_t> m_parts;
+    // words and bits of the last two columns
+    int m_rightWords[2];
+    std::uint64_t m_rightMasks[2];
+};
+
+SoupRunner::SoupRunner(const CensusOptions& options)
+        : m_options(options), m_size(options.boardSize),
+          m_engine(CreateEngine(options.engine, options.rule)),
+          m_current(m_size, m_size), m_next(m_size, m_size),
+          m_hashes(static_cast<size_t>(options.maxPeriod) + 1, 0),
+          m_grid(static_cast<size_t>(m_size) * m_size, 0),
+          m_parts(static_cast<size_t>(m_size) * m_size, 0) {
+    for (int i = 0; i < 2; i++) {
+        // cell x is bit x + 1
+        int bit = m_size - 1 + i;
+        m_rightWords[i] = bit / 64;
+        m_rightMasks[i] = std::uint64_t(1) << (bit % 64);
+    }
+}
+
+SoupResult SoupRunner::Run(const Board& soup) {
+    SoupResult result;
+    m_current.Clear();
+    int offset = (m_size - soup.GetWidth()) / 2;
+    for (int y = 0; y < soup.GetHeight(); y++) {
+        for (int x = 0; x < soup.GetWidth(); x++) {
+            m_current.Set(x + offset, y + offset, soup.Get(x, y));
+        }
+    }
+    m_current.RefreshHalo();
+
+    // period of a cycle that the hashes suggest, its phases are kept until it is confirmed
+    int candidate = 0;
+    int candidateStart = 0;
+    size_t ring = m_hashes.size();
+    for (int generation = 0; generation <= m_options.maxGenerations; generation++) {
+        removeEscaping(result.objects);
+        if (candidate != 0) {
+            int phase = generation - candidateStart;
+            if (phase < candidate) {
+                m_phases[phase] = m_current;
+            } else if (m_current == m_phases[0]) {
+                result.stabilized = true;
+                result.generations = candidateStart - candidate;
+                result.period = candidate;
+                break;
+            } else {
+                candidate = 0;
+            }
+        }
+
+        std::uint64_t hash = boardHash(m_current);
+        for (int period = 1; candidate == 0 && period <= std::min(generation, m_options.maxPeriod); period++) {
+            if (m_hashes[(generation - period) % ring] == hash) {
+                candidate = period;
+                candidateStart = generation;
+                m_phases.resize(period);
+                m_phases[0] = m_current;
+            }
+        }
+        m_hashes[generation % ring] = hash;
+
+        m_engine->Step(m_current, m_next);
+        std::swap(m_current, m_next);
+    }
+
+    if (result.stabilized) {
+        for (const std::vector<Cell>& object : separate()) {
+            result.objects.push_back(classify(*m_engine, object, result.period));
+        }
+    }
+    return result;
+}
+
+bool SoupRunner::touchesEdge() const {
+    for (int y : {0, 1, m_size - 2, m_size - 1}) {
+        const std::uint64_t* row = m_current.GetRow(y);
+        for (int w = 0; w < m_current.GetWordsPerRow(); w++) {
+            if (row[w] & m_current.GetInteriorMask(w)) {
+                return true;
+            }
+        }
+    }
+    for (int y = 2; y < m_size - 2; y++) {
+        const std::uint64_t* row = m_current.GetRow(y);
+        // columns 0 and 1 are bits 1 and 2
+        if ((row[0] & 6) || (row[m_rightWords[0]] & m_rightMasks[0]) || (row[m_rightWords[1]] & m_rightMasks[1])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// objects within two cells of the edge are leaving the soup, they are counted and taken off
+// before the edge can change them
+void SoupRunner::removeEscaping(std::vector<std::string>& objects) {
+    if (!touchesEdge()) {
+        return;
+    }
+
+    std::vector<Cell> cells = liveCells(m_current);
+    std::fill(m_grid.begin(), m_grid.end(), 0);
+    for (const Cell& cell : cells) {
+        m_grid[static_cast<size_t>(cell.second) * m_size + cell.first] = 1;
+    }
+    for (const Cell& cell : cells) {
+        bool nearEdge = std::min(cell.first, cell.second) < 2 || std::max(cell.first, cell.second) >= m_size - 2;
+        if (!nearEdge || m_grid[static_cast<size_t>(cell.second) * m_size + cell.first] == 0) {
+            continue;
+        }
+
+        std::vector<Cell> object = flood(m_grid, cell, 2);
+        objects.push_back(classify(*m_engine, object, m_options.maxPeriod));
+        for (const Cell& removed : object) {
+            m_current.Set(removed.first, removed.second, false);
+        }
+    }
+    std::fill(m_grid.begin(), m_grid.end(), 0);
+}
+
+std::vector<Cell> SoupRunner::flood(std::vector<std::uint8_t>& grid, Cell start, int reach) const {
+    std::vector<Cell> cells{start};
+    grid[static_cast<size_t>(start.second) * m_size + start.first] = 0;
+    for (size_t i = 0; i < cells.size(); i++) {
+        Cell cell = cells[i];
+        for (int y = std::max(0, cell.second - reach); y <= std::min(m_size - 1, cell.second + reach); y++) {
+            for (int x = std::max(0, cell.first - reach); x <= std::min(m_size - 1, cell.first + reach); x++) {
+                std::uint8_t& set = grid[static_cast<size_t>(y) * m_size + x];
+                if (set != 0) {
+                    set = 0;
+                    cells.emplace_back(x, y);
+                }
+            }
+        }
+    }
+    return cells;
+}
+
+std::vector<std::vector<Cell>> SoupRunner::separate() {
+    std::fill(m_grid.begin(), m_grid.end(), 0);
+    for (const Board& phase : m_phases) {
+        for (const Cell& cell : liveCells(phase)) {
+            m_grid[static_cast<size_t>(cell.second) * m_size + cell.first] = 1;
+        }
+    }
+
+    // a cell that changes has a live cell within one cell of it, so cells three or more apart in
+    // every phase never meet
+    std::vector<std::vector<Cell>> objects;
+    for (const Cell& cell : liveCells(m_phases[0])) {
+        if (m_grid[static_cast<size_t>(cell.second) * m_size + cell.first] == 0) {
+            continue;
+        }
+
+        std::vector<Cell> cluster = flood(m_grid, cell, 2);
+        for (const Cell& member : cluster) {
+            m_parts[static_cast<size_t>(member.second) * m_size + member.first] = 1;
+        }
+        std::vector<std::vector<Cell>> parts;
+        for (const Cell& member : cluster) {
+            if (m_parts[static_cast<size_t>(member.second) * m_size + member.first] != 0) {
+                parts.push_back(flood(m_parts, member, 1));
+            }
+        }
+
+        bool split = parts.size() > 1;
+        for (size_t i = 0; split && i < parts.size(); i++) {
+            split = runsAlone(parts[i]);
+        }
+        if (split) {
+            for (const std::vector<Cell>& part : parts) {
+                objects.push_back(firstPhase(part));
+            }
+        } else {
+            objects.push_back(firstPhase(cluster));
+        }
+    }
+    return objects;
+}
+
+// whether the part goes through the same phases with the rest of the ash taken away
+bool SoupRunner::runsAlone(const std::vector<Cell>& part) {
+    std::vector<Cell> cells = part;
+    std::sort(cells.begin(), cells.end(), rowMajor);
+    int period = static_cast<int>(m_phases.size());
+    std::vector<std::vector<Cell>> generations = evolve(*m_engine, firstPhase(cells), period);
+    for (int generation = 1; generation <= period; generation++) {
+        const Board& phase = m_phases[generation % period];
+        std::vector<Cell> expected;
+        for (const Cell& cell : cells) {
+            if (phase.Get(cell.first, cell.second)) {
+                expected.push_back(cell);
+            }
+        }
+        if (generations[generation] != expected) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<Cell> SoupRunner::firstPhase(const std::vector<Cell>& cells) const {
+    std::vector<Cell> alive;
+    for (const Cell& cell : cells) {
+        if (m_phases[0].Get(cell.first, cell.second)) {
+            alive.push_back(cell);
+        }
+    }
+    return alive;
+}
+
+}
+
+void ObjectTally::Add(const std::string& code, std::uint64_t count) {
+    Shard& shard = getShard(code);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.counts[code] += count;
+}
+
+void ObjectTally::Merge(const std::unordered_map<std::string, std::uint64_t>& counts) {
+    for (const auto& entry : counts) {
+        Add(entry.first, entry.second);
+    }
+}
+
+void ObjectTally::Clear() {
+    for (Shard& shard : m_shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.counts.clear();
+    }
+}
+
+std::vector<std::pair<std::string, std::uint64_t>> ObjectTally::GetCounts() const {
+    std::vector<std::pair<std::string, std::uint64_t>> counts;
+    for (const Shard& shard : m_shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        counts.insert(counts.end(), shard.counts.begin(), shard.counts.end());
+    }
+    std::sort(counts.begin(), counts.end(), [](const auto& left, const auto& right) {
+        return left.second != right.second ? left.second > right.second : left.first < right.first;
+    });
+    return counts;
+}
+
+ObjectTally::Shard& ObjectTally::getShard(const std::string& code) {
+    return m_shards[std::hash<std::string>()(code) % ShardCount];
+}
+
+Census::Census(const CensusOptions& options, int threadCount)
+        : m_options(options), m_pool(threadCount), m_tally(), m_soupCount(0), m_unstabilizedCount(0) {
+}
+
+bool Census::Supports(const CensusOptions& options) {
+    if (options.rule.states != 2 || options.rule.radius != 1 || !CreateEngine(options.engine, options.rule)) {
+        return false;
+    }
+    return options.soupSize > 0 && options.boardSize >= options.soupSize + 8 && options.maxPeriod > 0
+           && options.maxGenerations >= 0;
+}
+
+const CensusOptions& Census::GetOptions() const {
+    return m_options;
+}
+
+int Census::GetThreadCount() const {
+    return m_pool.GetThreadCount();
+}
+
+Board Census::MakeSoup(long long index) const {
+    // seeds one apart would otherwise give overlapping streams
+    std::uint64_t state = m_options.seed ^ static_cast<std::uint64_t>(index) * 0xD1B54A32D192ED03ull;
+    Board soup(m_options.soupSize, m_options.soupSize);
+    soup.Randomize(splitMix64(state), m_options.density);
+    return soup;
+}
+
+SoupResult Census::RunSoup(long long index) const {
+    SoupRunner runner(m_options);
+    return runner.Run(MakeSoup(index));
+}
+
+void Census::Run(long long first, long long count) {
+    GOL_TRACE_SCOPE("Census::Run");
+    // ParallelFor counts are ints
+    const long long roundSize = 1 << 20;
+    for (long long done = 0; done < count; done += roundSize) {
+        long long roundFirst = first + done;
+        m_pool.ParallelFor(static_cast<int>(std::min(roundSize, count - done)), [this, roundFirst](int begin, int end) {
+            SoupRunner runner(m_options);
+            std::unordered_map<std::string, std::uint64_t> counts;
+            std::uint64_t unstabilized = 0;
+            for (int i = begin; i < end; i++) {
+                SoupResult result = runner.Run(MakeSoup(roundFirst + i));
+                if (!result.stabilized) {
+                    unstabilized++;
+                    continue;
+                }
+                for (const std::string& code : result.objects) {
+                    counts[code]++;
+                }
+            }
+            m_tally.Merge(counts);
+            m_soupCount += static_cast<std::uint64_t>(end - begin);
+            m_unstabilizedCount += unstabilized;
+        });
+    }
+}
+
+const ObjectTally& Census::GetTally() const {
+    return m_tally;
+}
+
+std::uint64_t Census::GetSoupCount() const {
+    return m_soupCount;
+}
+
+std::uint64_t Census::GetUnstabilizedCount() const {
+    return m_unstabilizedCount;
+}
@@ -0,0 +1,111 @@
+#ifndef GAME_OF_LIFE_CENSUS_H
+#define GAME_OF_LIFE_CENSUS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "board.h"
+#include "rule.h"
+#include "thread_pool.h"
+
+// Counts of objects by code that any number of threads can add to at once: the codes are spread
+// over shards by their hash and every shard has a lock of its own.
+class ObjectTally {
+public:
+    void Add(const std::string& code, std::uint64_t count = 1);
+    // adds the counts a single thread has kept on its own
+    void Merge(const std::unordered_map<std::string, std::uint64_t>& counts);
+    void Clear();
+
+    // most common first, then by code
+    std::vector<std::pair<std::string, std::uint64_t>> GetCounts() const;
+
+private:
+    static const int ShardCount = 64;
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, std::uint64_t> counts;
+    };
+
+    Shard& getShard(const std::string& code);
+
+    std::array<Shard, ShardCount> m_shards;
+};
+
+struct CensusOptions {
+    Rule rule = ConwayRule;
+    std::string engine = "bitwise";
+    std::uint64_t seed = 1;
+    // soups are squares of this size filled with live cells at the density
+    int soupSize = 16;
+    float density = .5f;
+    // the soup runs in the middle of a bounded square board of this size, objects that come
+    // within two cells of its edge are taken off and counted as escaping
+    int boardSize = 254;
+    // soups that have not settled into a cycle of at most maxPeriod generations by then are
+    // counted as unstabilized and their objects are not counted
+    int maxGenerations = 1 << 15;
+    int maxPeriod = 60;
+};
+
+// What one soup left behind.
+struct SoupResult {
+    bool stabilized = false;
+    // generation from which the ash repeats, and its period
+    int generations = 0;
+    int period = 0;
+    // codes of the objects of the ash and of the escaping ones, in no particular order
+    std::vector<std::string> objects;
+};
+
+// Runs random soups until they settle and counts the objects they leave behind by a canonical
+// code, in the format of apgsearch: xs<population> for still lifes, xp<period> for oscillators
+// and xq<period> for spaceships, followed by the extended Wechsler code of the phase and the
+// rotation or reflection with the shortest, then the least code, "xs4_33" for the block. Objects
+// that do not repeat within the maximum period are "zz_unidentified".
+//
+// The ash is split into objects that cannot reach each other: cells of any phase of the period
+// closer than three cells apart belong to the same object. Objects within that distance are
+// then split into their connected parts if every part runs through the same phases on its own.
+//
+// Soups are numbered and soup i is the same whatever the thread that runs it, so a census over
+// a range of soups does not depend on the number of threads.
+class Census {
+public:
+    // threads in total, hardware concurrency when 0
+    explicit Census(const CensusOptions& options, int threadCount = 0);
+
+    // two-state rules of radius 1 that the engine runs
+    static bool Supports(const CensusOptions& options);
+
+    const CensusOptions& GetOptions() const;
+    int GetThreadCount() const;
+
+    Board MakeSoup(long long index) const;
+    // runs one soup on the calling thread without counting it
+    SoupResult RunSoup(long long index) const;
+
+    // runs soups [first, first + count) on every thread, each keeps its own tally that is merged
+    // into the shared one once its share of soups is done
+    void Run(long long first, long long count);
+
+    const ObjectTally& GetTally() const;
+    std::uint64_t GetSoupCount() const;
+    std::uint64_t GetUnstabilizedCount() const;
+
+private:
+    CensusOptions m_options;
+    ThreadPool m_pool;
+    ObjectTally m_tally;
+    std::atomic<std::uint64_t> m_soupCount;
+    std::atomic<std::uint64_t> m_unstabilizedCount;
+};
+
+#endif //GAME_OF_LIFE_CENSUS_H
@@ -0,0 +1,401 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "checkpoint.h"
+#include "../profiling/trace.h"
+
+namespace {
+
+const char checkpointMagic[4] = {'G', 'O', 'L', 'P'};
+const std::uint32_t checkpointVersion = 1;
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+#if !defined(_WIN32)
+// runs in the forked child: only async-signal-safe calls, the parent may have held
+// the allocator lock at the time of the fork
+bool writeAll(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = write(fd, bytes, size);
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool writeCheckpointRaw(const char* temporaryPath, const char* path, const Universe& universe,
+                        const CheckpointFileHeader& header) {
+    int fd = open(temporaryPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    bool ok = writeAll(fd, &header, sizeof(header));
+    universe.ForEachChunk([&](std::int32_t x, std::int32_t y, const Board& board) {
+        std::int32_t coordinates[2] = {x, y};
+        ok = ok && writeAll(fd, coordinates, sizeof(coordinates));
+        size_t rowBytes = sizeof(std::uint64_t) * board.GetWordsPerRow();
+        for (int plane = 0; ok && plane < board.GetPlaneCount(); plane++) {
+            for (int row = 0; ok && row < board.GetHeight(); row++) {
+                ok = writeAll(fd, board.GetRow(row, plane), rowBytes);
+            }
+        }
+    });
+    ok = close(fd) == 0 && ok;
+    return ok && rename(temporaryPath, path) == 0;
+}
+#endif
+
+bool writeCheckpoint(std::ostream& stream, const std::vector<CheckpointChunk>& chunks, size_t count,
+                     int planeCount, std::uint64_t generation) {
+    CheckpointFileHeader header = MakeCheckpointFileHeader(generation, planeCount, count);
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (size_t i = 0; i < count; i++) {
+        const CheckpointChunk& chunk = chunks[i];
+        std::int32_t coordinates[2] = {chunk.x, chunk.y};
+        stream.write(reinterpret_cast<const char*>(coordinates), sizeof(coordinates));
+        auto rowBytes = static_cast<std::streamsize>(sizeof(std::uint64_t) * chunk.board.GetWordsPerRow());
+        for (int plane = 0; plane < chunk.board.GetPlaneCount(); plane++) {
+            for (int y = 0; y < chunk.board.GetHeight(); y++) {
+                stream.write(reinterpret_cast<const char*>(chunk.board.GetRow(y, plane)), rowBytes);
+            }
+        }
+    }
+    return static_cast<bool>(stream);
+}
+
+bool readCheckpoint(std::istream& stream, int planeCount, std::vector<CheckpointChunk>& chunks,
+                    std::uint64_t& generation) {
+    CheckpointFileHeader header{};
+    stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!stream || std::memcmp(header.magic, checkpointMagic, sizeof(checkpointMagic)) != 0
+        || header.version != checkpointVersion || header.chunkSize != Universe::ChunkSize) {
+        std::cout << "ERROR::CHECKPOINT: Not a checkpoint file" << std::endl;
+        return false;
+    }
+    if (header.planeCount != static_cast<std::uint32_t>(planeCount)) {
+        std::cout << "ERROR::CHECKPOINT: The checkpoint has " << header.planeCount << " state planes, the rule has "
+                  << planeCount << std::endl;
+        return false;
+    }
+
+    // the count is not trusted with a reservation, a truncated file ends the loop
+    chunks.clear();
+    for (std::uint64_t i = 0; i < header.chunkCount; i++) {
+        CheckpointChunk chunk{0, 0, Board(Universe::ChunkSize, Universe::ChunkSize, planeCount)};
+        std::int32_t coordinates[2];
+        stream.read(reinterpret_cast<char*>(coordinates), sizeof(coordinates));
+        auto rowBytes = static_cast<std::streamsize>(sizeof(std::uint64_t) * chunk.board.GetWordsPerRow());
+        for (int plane = 0; stream && plane < planeCount; plane++) {
+            for (int y = 0; stream && y < chunk.board.GetHeight(); y++) {
+                stream.read(reinterpret_cast<char*>(chunk.board.GetRow(y, plane)), rowBytes);
+            }
+        }
+        if (!stream) {
+            std::cout << "ERROR::CHECKPOINT: Truncated checkpoint file" << std::endl;
+            return false;
+        }
+        chunk.x = coordinates[0];
+        chunk.y = coordinates[1];
+        chunks.push_back(std::move(chunk));
+    }
+    generation = header.generation;
+    return true;
+}
+
+}
+
+CheckpointFileHeader MakeCheckpointFileHeader(std::uint64_t generation, int planeCount, std::uint64_t chunkCount) {
+    CheckpointFileHeader header{};
+    std::memcpy(header.magic, checkpointMagic, sizeof(checkpointMagic));
+    header.version = checkpointVersion;
+    header.generation = generation;
+    header.chunkSize = Universe::ChunkSize;
+    header.planeCount = static_cast<std::uint32_t>(planeCount);
+    header.chunkCount = chunkCount;
+    return header;
+}
+
+bool SaveCheckpoint(const std::string& path, const std::vector<CheckpointChunk>& chunks, size_t count,
+                    int planeCount, std::uint64_t generation) {
+    std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file || !writeCheckpoint(file, chunks, count, planeCount, generation)) {
+            std::cout << "ERROR::CHECKPOINT: Failed to write " << temporaryPath << std::endl;
+            return false;
+        }
+    }
+
+#if defined(_WIN32)
+    // rename does not replace an existing file on windows
+    std::remove(path.c_str());
+#endif
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        std::cout << "ERROR::CHECKPOINT: Failed to rename " << temporaryPath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool SaveCheckpoint(const std::string& path, const Universe& universe) {
+    std::vector<CheckpointChunk> chunks;
+    universe.ForEachChunk([&](std::int32_t x, std::int32_t y, const Board& board) {
+        chunks.push_back({x, y, board});
+    });
+    return SaveCheckpoint(path, chunks, chunks.size(), GetStatePlaneCount(universe.GetEngine().GetRule()),
+                          universe.GetGeneration());
+}
+
+bool LoadCheckpoint(const std::string& path, Universe& universe) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cout << "ERROR::CHECKPOINT: Failed to open " << path << std::endl;
+        return false;
+    }
+
+    std::vector<CheckpointChunk> chunks;
+    std::uint64_t generation;
+    if (!readCheckpoint(file, GetStatePlaneCount(universe.GetEngine().GetRule()), chunks, generation)) {
+        return false;
+    }
+
+    universe.Clear();
+    for (const CheckpointChunk& chunk : chunks) {
+        universe.Paste(chunk.board, static_cast<std::int64_t>(chunk.x) * Universe::ChunkSize,
+                       static_cast<std::int64_t>(chunk.y) * Universe::ChunkSize);
+    }
+    universe.SetGeneration(generation);
+    return true;
+}
+
+Checkpointer::Checkpointer(std::string directory, std::uint64_t interval, CheckpointMode mode)
+        : m_directory(std::move(directory)), m_mode(mode), m_backCount(0), m_backPlaneCount(1), m_backGeneration(0),
+          m_busy(false), m_stop(false), m_child(0), m_childGeneration(0) {
+#if defined(_WIN32)
+    if (m_mode == CheckpointMode::Fork) {
+        std::cout << "WARNING::CHECKPOINT: fork is not available, using a writer thread" << std::endl;
+        m_mode = CheckpointMode::WriterThread;
+    }
+#endif
+    m_stats.interval = interval;
+
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    if (error) {
+        std::cout << "ERROR::CHECKPOINT: Failed to create " << m_directory << ": " << error.message() << std::endl;
+    }
+
+    if (m_mode == CheckpointMode::WriterThread) {
+        m_writer = std::thread(&Checkpointer::writerLoop, this);
+    }
+}
+
+Checkpointer::~Checkpointer() {
+    if (m_writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_condition.notify_all();
+        m_writer.join();
+    }
+    reapChild(true);
+}
+
+void Checkpointer::OnGeneration(const Universe& universe) {
+    if (m_mode == CheckpointMode::Fork) {
+        reapChild(false);
+    }
+
+    std::uint64_t interval = GetInterval();
+    if (interval == 0 || universe.GetGeneration() % interval != 0) {
+        return;
+    }
+
+    if (m_mode == CheckpointMode::Fork) {
+        forkWriter(universe);
+    } else {
+        handOffToWriter(universe);
+    }
+}
+
+std::uint64_t Checkpointer::GetInterval() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats.interval;
+}
+
+void Checkpointer::SetInterval(std::uint64_t interval) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.interval = interval;
+}
+
+CheckpointMode Checkpointer::GetMode() const {
+    return m_mode;
+}
+
+CheckpointStats Checkpointer::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+std::string Checkpointer::GetPath(std::uint64_t generation) const {
+    return (std::filesystem::path(m_directory) / ("checkpoint_" + std::to_string(generation) + ".golp")).string();
+}
+
+void Checkpointer::handOffToWriter(const Universe& universe) {
+    GOL_TRACE_SCOPE("Checkpointer::handOff");
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_busy) {
+            m_stats.skipped++;
+            return;
+        }
+    }
+
+    // the writer only touches the back buffer while busy, so the copy needs no locking; a chunk is
+    // a copy of its words into a board that usually has the room already
+    size_t count = 0;
+    universe.ForEachChunk([&](std::int32_t x, std::int32_t y, const Board& board) {
+        if (count == m_backChunks.size()) {
+            m_backChunks.emplace_back();
+        }
+        CheckpointChunk& chunk = m_backChunks[count++];
+        chunk.x = x;
+        chunk.y = y;
+        chunk.board = board;
+    });
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_backCount = count;
+        m_backPlaneCount = GetStatePlaneCount(universe.GetEngine().GetRule());
+        m_backGeneration = universe.GetGeneration();
+        m_busy = true;
+    }
+    m_condition.notify_one();
+    recordStall(start);
+}
+
+void Checkpointer::writerLoop() {
+    GOL_TRACE_THREAD_NAME("checkpoint writer");
+    while (true) {
+        std::uint64_t generation;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_busy || m_stop; });
+            if (!m_busy) {
+                return;
+            }
+            generation = m_backGeneration;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        bool saved;
+        {
+            GOL_TRACE_SCOPE("Checkpointer::write");
+            saved = SaveCheckpoint(GetPath(generation), m_backChunks, m_backCount, m_backPlaneCount, generation);
+        }
+        double durationMs = millisecondsSince(start);
+
+        if (saved) {
+            recordWritten(generation, durationMs);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_busy = false;
+    }
+}
+
+void Checkpointer::forkWriter(const Universe& universe) {
+#if !defined(_WIN32)
+    if (m_child != 0) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.skipped++;
+        return;
+    }
+
+    // everything the child needs is prepared before the fork, it walks the chunks in place
+    std::uint64_t generation = universe.GetGeneration();
+    std::string path = GetPath(generation);
+    std::string temporaryPath = path + ".tmp";
+    CheckpointFileHeader header = MakeCheckpointFileHeader(
+            generation, GetStatePlaneCount(universe.GetEngine().GetRule()), universe.GetChunkCount());
+
+    GOL_TRACE_SCOPE("Checkpointer::fork");
+    auto start = std::chrono::steady_clock::now();
+    pid_t child = fork();
+    if (child == 0) {
+        _exit(writeCheckpointRaw(temporaryPath.c_str(), path.c_str(), universe, header) ? 0 : 1);
+    }
+    recordStall(start);
+
+    if (child < 0) {
+        std::cout << "ERROR::CHECKPOINT: fork failed" << std::endl;
+        return;
+    }
+    m_child = child;
+    m_childGeneration = generation;
+    m_childStart = start;
+#endif
+}
+
+bool Checkpointer::reapChild(bool wait) {
+#if !defined(_WIN32)
+    if (m_child == 0) {
+        return false;
+    }
+
+    int status = 0;
+    pid_t result = waitpid(static_cast<pid_t>(m_child), &status, wait ? 0 : WNOHANG);
+    if (result == 0) {
+        return false;
+    }
+
+    // the duration is only observed when the simulation polls, so it is rounded up to a generation
+    double durationMs = millisecondsSince(m_childStart);
+    m_child = 0;
+    if (result < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        std::cout << "ERROR::CHECKPOINT: Failed to write " << GetPath(m_childGeneration) << std::endl;
+        return false;
+    }
+
+    recordWritten(m_childGeneration, durationMs);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Checkpointer::recordStall(std::chrono::steady_clock::time_point start) {
+    double stallMs = millisecondsSince(start);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.lastStallMs = stallMs;
+    m_stats.maxStallMs = std::max(m_stats.maxStallMs, stallMs);
+}
+
+void Checkpointer::recordWritten(std::uint64_t generation, double durationMs) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.written++;
+    m_stats.lastGeneration = generation;
+    m_stats.lastDurationMs = durationMs;
+}
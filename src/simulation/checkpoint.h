@@ -0,0 +1,117 @@
+#ifndef GAME_OF_LIFE_CHECKPOINT_H
+#define GAME_OF_LIFE_CHECKPOINT_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "board.h"
+#include "universe.h"
+
+enum class CheckpointMode {
+    // the chunk boards are copied into a back buffer that a writer thread serializes
+    WriterThread,
+    // a forked child serializes its copy-on-write view of the chunks, POSIX only
+    Fork
+};
+
+// Checkpoint file: this header followed by every chunk of the plane, its x and y as two int32 and
+// then its board as in a board file, GetWordsPerRow() little endian words per row, top to bottom,
+// for each state plane in turn. Cell (0, 0) of a chunk is cell (x * chunkSize, y * chunkSize) of
+// the plane, so the cells keep their place however far apart they are.
+struct CheckpointFileHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t generation;
+    std::int32_t chunkSize;
+    std::uint32_t planeCount;
+    std::uint64_t chunkCount;
+};
+
+struct CheckpointChunk {
+    std::int32_t x;
+    std::int32_t y;
+    Board board;
+};
+
+CheckpointFileHeader MakeCheckpointFileHeader(std::uint64_t generation, int planeCount, std::uint64_t chunkCount);
+
+// writes the first count chunks to a temporary file first, as SaveBoard
+bool SaveCheckpoint(const std::string& path, const std::vector<CheckpointChunk>& chunks, size_t count,
+                    int planeCount, std::uint64_t generation);
+bool SaveCheckpoint(const std::string& path, const Universe& universe);
+// replaces the cells and the generation of the universe, whose rule must have the plane count of
+// the checkpoint
+bool LoadCheckpoint(const std::string& path, Universe& universe);
+
+struct CheckpointStats {
+    std::uint64_t interval = 0;
+    std::uint64_t written = 0;
+    // checkpoints dropped because the previous one was still being written
+    std::uint64_t skipped = 0;
+    std::uint64_t lastGeneration = 0;
+    // time spent serializing the last finished checkpoint
+    double lastDurationMs = 0;
+    // time the simulation thread was blocked handing the chunks off
+    double lastStallMs = 0;
+    double maxStallMs = 0;
+};
+
+// Writes the chunks of the plane to <directory>/checkpoint_<generation>.golp every interval
+// generations without making the simulation thread wait for the disk. Nothing is copied before
+// it is known that no checkpoint is still being written.
+class Checkpointer {
+public:
+    Checkpointer(std::string directory, std::uint64_t interval, CheckpointMode mode = CheckpointMode::WriterThread);
+    ~Checkpointer();
+
+    Checkpointer(const Checkpointer&) = delete;
+    Checkpointer& operator=(const Checkpointer&) = delete;
+
+    // called by the simulation thread at every generation boundary, 0 interval disables checkpoints
+    void OnGeneration(const Universe& universe);
+
+    std::uint64_t GetInterval() const;
+    void SetInterval(std::uint64_t interval);
+
+    CheckpointMode GetMode() const;
+    CheckpointStats GetStats() const;
+
+    std::string GetPath(std::uint64_t generation) const;
+
+private:
+    void handOffToWriter(const Universe& universe);
+    void writerLoop();
+
+    void forkWriter(const Universe& universe);
+    bool reapChild(bool wait);
+
+    void recordStall(std::chrono::steady_clock::time_point start);
+    void recordWritten(std::uint64_t generation, double durationMs);
+
+    std::string m_directory;
+    CheckpointMode m_mode;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    CheckpointStats m_stats;
+
+    std::thread m_writer;
+    // boards of chunks past m_backCount are kept for their memory
+    std::vector<CheckpointChunk> m_backChunks;
+    size_t m_backCount;
+    int m_backPlaneCount;
+    std::uint64_t m_backGeneration;
+    bool m_busy;
+    bool m_stop;
+
+    long m_child;
+    std::uint64_t m_childGeneration;
+    std::chrono::steady_clock::time_point m_childStart;
+};
+
+#endif //GAME_OF_LIFE_CHECKPOINT_H
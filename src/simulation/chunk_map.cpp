@@ -0,0 +1,83 @@
+#include "chunk_map.h"
+
+namespace {
+
+const size_t initialCapacity = 64;
+
+}
+
+ChunkMap::ChunkMap() : m_slots(initialCapacity, Slot{0, -1}), m_mask(initialCapacity - 1), m_size(0) {
+}
+
+size_t ChunkMap::home(std::uint64_t key) const {
+    // Fibonacci hashing, neighbouring chunk coordinates land far apart
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & m_mask;
+}
+
+int ChunkMap::Find(std::uint64_t key) const {
+    for (size_t slot = home(key);; slot = (slot + 1) & m_mask) {
+        if (m_slots[slot].index < 0) {
+            return -1;
+        }
+        if (m_slots[slot].key == key) {
+            return m_slots[slot].index;
+        }
+    }
+}
+
+void ChunkMap::Insert(std::uint64_t key, int index) {
+    if (2 * (m_size + 1) > m_slots.size()) {
+        grow();
+    }
+
+    size_t slot = home(key);
+    while (m_slots[slot].index >= 0) {
+        slot = (slot + 1) & m_mask;
+    }
+    m_slots[slot] = Slot{key, index};
+    m_size++;
+}
+
+void ChunkMap::Erase(std::uint64_t key) {
+    size_t slot = home(key);
+    for (; m_slots[slot].index < 0 || m_slots[slot].key != key; slot = (slot + 1) & m_mask) {
+        if (m_slots[slot].index < 0) {
+            return;
+        }
+    }
+
+    // moves later entries of the probe run into the hole when the hole lies between their home
+    // slot and where they are now
+    size_t hole = slot;
+    for (size_t next = (hole + 1) & m_mask; m_slots[next].index >= 0; next = (next + 1) & m_mask) {
+        size_t nextHome = home(m_slots[next].key);
+        if (((next - nextHome) & m_mask) >= ((next - hole) & m_mask)) {
+            m_slots[hole] = m_slots[next];
+            hole = next;
+        }
+    }
+    m_slots[hole].index = -1;
+    m_size--;
+}
+
+void ChunkMap::Clear() {
+    m_slots.assign(initialCapacity, Slot{0, -1});
+    m_mask = initialCapacity - 1;
+    m_size = 0;
+}
+
+size_t ChunkMap::GetSize() const {
+    return m_size;
+}
+
+void ChunkMap::grow() {
+    std::vector<Slot> slots(2 * m_slots.size(), Slot{0, -1});
+    std::swap(slots, m_slots);
+    m_mask = m_slots.size() - 1;
+    m_size = 0;
+    for (const Slot& slot : slots) {
+        if (slot.index >= 0) {
+            Insert(slot.key, slot.index);
+        }
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef GAME_OF_LIFE_CHUNK_MAP_H
+#define GAME_OF_LIFE_CHUNK_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Open addressing hash map from 64-bit keys to non-negative indices, with linear probing and
+// backward shift deletion so lookups never walk over tombstones. Kept at most half full.
+class ChunkMap {
+public:
+    ChunkMap();
+
+    // the index stored for the key, -1 when it is absent
+    int Find(std::uint64_t key) const;
+    // the key must be absent
+    void Insert(std::uint64_t key, int index);
+    void Erase(std::uint64_t key);
+    void Clear();
+
+    size_t GetSize() const;
+
+private:
+    struct Slot {
+        std::uint64_t key;
+        // -1 for an empty slot
+        int index;
+    };
+
+    size_t home(std::uint64_t key) const;
+    void grow();
+
+    std::vector<Slot> m_slots;
+    size_t m_mask;
+    size_t m_size;
+};
+
+#endif //GAME_OF_LIFE_CHUNK_MAP_H
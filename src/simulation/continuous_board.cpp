@@ -0,0 +1,55 @@
+#include <algorithm>
+#include <random>
+
+#include "continuous_board.h"
+
+ContinuousBoard::ContinuousBoard() : ContinuousBoard(0, 0) {
+}
+
+ContinuousBoard::ContinuousBoard(int width, int height)
+        : m_width(width), m_height(height), m_cells(static_cast<size_t>(width) * height, 0.f) {
+}
+
+int ContinuousBoard::GetWidth() const {
+    return m_width;
+}
+
+int ContinuousBoard::GetHeight() const {
+    return m_height;
+}
+
+float ContinuousBoard::Get(int x, int y) const {
+    return GetRow(y)[x];
+}
+
+void ContinuousBoard::Set(int x, int y, float value) {
+    GetRow(y)[x] = value;
+}
+
+void ContinuousBoard::Clear() {
+    std::fill(m_cells.begin(), m_cells.end(), 0.f);
+}
+
+void ContinuousBoard::Randomize(std::uint64_t seed, float density) {
+    std::mt19937_64 random(seed);
+    std::uniform_real_distribution<float> uniform(0.f, 1.f);
+    for (float& cell : m_cells) {
+        cell = uniform(random) < density ? uniform(random) : 0.f;
+    }
+}
+
+double ContinuousBoard::GetMass() const {
+    double mass = 0;
+    for (float cell : m_cells) {
+        mass += cell;
+    }
+    return mass;
+}
+
+const float* ContinuousBoard::GetRow(int y) const {
+    return m_cells.data() + static_cast<size_t>(y) * m_width;
+}
+
+float* ContinuousBoard::GetRow(int y) {
+    return m_cells.data() + static_cast<size_t>(y) * m_width;
+}
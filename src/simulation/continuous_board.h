@@ -0,0 +1,36 @@
+#ifndef GAME_OF_LIFE_CONTINUOUS_BOARD_H
+#define GAME_OF_LIFE_CONTINUOUS_BOARD_H
+
+#include <cstdint>
+#include <vector>
+
+// Field of cells with a continuous state in [0, 1], as Lenia runs on, stored row-major.
+// The cells beyond the edges count as 0.
+class ContinuousBoard {
+public:
+    ContinuousBoard();
+    ContinuousBoard(int width, int height);
+
+    int GetWidth() const;
+    int GetHeight() const;
+
+    float Get(int x, int y) const;
+    void Set(int x, int y, float value);
+
+    void Clear();
+    // cells with the given density get a uniformly random state, the others 0
+    void Randomize(std::uint64_t seed, float density);
+
+    // sum of the states, what Lenia calls the mass
+    double GetMass() const;
+
+    const float* GetRow(int y) const;
+    float* GetRow(int y);
+
+private:
+    int m_width;
+    int m_height;
+    std::vector<float> m_cells;
+};
+
+#endif //GAME_OF_LIFE_CONTINUOUS_BOARD_H
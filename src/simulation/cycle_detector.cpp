@@ -0,0 +1,74 @@
+#include "cycle_detector.h"
+#include "../profiling/trace.h"
+
+CycleDetector::CycleDetector(size_t window)
+        : m_window(window), m_generations(), m_hashes(), m_generation(0), m_period(0), m_cycleStart(0) {
+}
+
+void CycleDetector::Record(const Universe& universe) {
+    GOL_TRACE_SCOPE("CycleDetector::Record");
+    if (IsPeriodic() && universe.GetGeneration() == m_generation + 1) {
+        m_generation++;
+        return;
+    }
+    if (!m_hashes.empty() && universe.GetGeneration() != m_generation + 1) {
+        // the universe was rewound, edited or jumped ahead, the table no longer leads here
+        Clear();
+    }
+
+    std::uint64_t hash = universe.GetHash();
+    m_generation = universe.GetGeneration();
+    auto found = m_generations.find(hash);
+    if (found != m_generations.end()) {
+        m_cycleStart = found->second;
+        m_period = m_generation - m_cycleStart;
+        return;
+    }
+
+    m_generations.emplace(hash, m_generation);
+    m_hashes.push_back(hash);
+    if (m_hashes.size() > m_window) {
+        m_generations.erase(m_hashes.front());
+        m_hashes.pop_front();
+    }
+}
+
+void CycleDetector::Clear() {
+    m_generations.clear();
+    m_hashes.clear();
+    m_period = 0;
+    m_cycleStart = 0;
+}
+
+bool CycleDetector::IsPeriodic() const {
+    return m_period != 0;
+}
+
+std::uint64_t CycleDetector::GetPeriod() const {
+    return m_period;
+}
+
+std::uint64_t CycleDetector::GetCycleStart() const {
+    return m_cycleStart;
+}
+
+std::uint64_t CycleDetector::GetStepsTo(std::uint64_t generation, std::uint64_t target) const {
+    // the distance modulo the period, taken so that targets before generation work too
+    std::uint64_t phase = (generation - m_cycleStart) % m_period;
+    std::uint64_t targetPhase = (target - m_cycleStart) % m_period;
+    return (targetPhase + m_period - phase) % m_period;
+}
+
+bool CycleDetector::FastForward(Universe& universe, std::uint64_t target) {
+    GOL_TRACE_SCOPE("CycleDetector::FastForward");
+    if (!IsPeriodic() || universe.GetGeneration() != m_generation || target < m_generation) {
+        return false;
+    }
+
+    for (std::uint64_t steps = GetStepsTo(m_generation, target); steps > 0; steps--) {
+        universe.Step();
+    }
+    universe.SetGeneration(target);
+    m_generation = target;
+    return true;
+}
@@ -0,0 +1,49 @@
+#ifndef GAME_OF_LIFE_CYCLE_DETECTOR_H
+#define GAME_OF_LIFE_CYCLE_DETECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+
+#include "universe.h"
+
+// Finds the generation from which the whole universe repeats, from a table of the hashes of the
+// recent generations. Once the universe is periodic any later generation is the same board as
+// one within a period of the current one, so far generations are reached with fewer than a
+// period of steps. Two different boards share a hash with a chance of about window^2 / 2^65.
+class CycleDetector {
+public:
+    // cycles up to window generations long are found
+    explicit CycleDetector(size_t window);
+
+    // remembers the generation the universe has just reached, a generation that does not follow
+    // the last one starts over; nothing is recorded once a cycle has been found
+    void Record(const Universe& universe);
+    void Clear();
+
+    bool IsPeriodic() const;
+    std::uint64_t GetPeriod() const;
+    // first generation of the cycle that is in the table
+    std::uint64_t GetCycleStart() const;
+    // how many steps from generation reach the board of the target generation, both at or
+    // after the start of the cycle
+    std::uint64_t GetStepsTo(std::uint64_t generation, std::uint64_t target) const;
+
+    // steps the periodic universe, at the last recorded generation, to the board of the later
+    // target generation in fewer steps than a period and numbers it target; false when no cycle
+    // has been found
+    bool FastForward(Universe& universe, std::uint64_t target);
+
+private:
+    size_t m_window;
+    std::unordered_map<std::uint64_t, std::uint64_t> m_generations;
+    // hashes in the order they were recorded, the oldest ones leave the table first
+    std::deque<std::uint64_t> m_hashes;
+    // generation of the newest hash
+    std::uint64_t m_generation;
+    std::uint64_t m_period;
+    std::uint64_t m_cycleStart;
+};
+
+#endif //GAME_OF_LIFE_CYCLE_DETECTOR_H
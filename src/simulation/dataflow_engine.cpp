@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "dataflow_engine.h"
+#include "bit_kernel.h"
+#include "../profiling/trace.h"
+
+namespace {
+
+// the tiles of a board in rows of tiles, tile t covering rows and words from its corner on
+struct TileGrid {
+    int tileRows;
+    int tileWords;
+    int height;
+    int wordsPerRow;
+    int rowTiles;
+    int columnTiles;
+
+    TileGrid(const Board& board, int rows, int words)
+            : tileRows(rows), tileWords(words), height(board.GetHeight()), wordsPerRow(board.GetWordsPerRow()),
+              rowTiles((height + rows - 1) / rows), columnTiles((wordsPerRow + words - 1) / words) {
+    }
+
+    int GetCount() const {
+        return rowTiles * columnTiles;
+    }
+};
+
+// steps the rows and words of a tile and clears the cells of the first and last word of the rows
+// that lie beyond the edges of the board, which leaves a bounded board's halo right without a
+// RefreshHalo
+template<typename Kernel>
+void stepTile(const Kernel& nextState, const TileGrid& grid, const Board& current, Board& next, int tile) {
+    int firstRow = tile / grid.columnTiles * grid.tileRows;
+    int lastRow = std::min(firstRow + grid.tileRows, grid.height);
+    int firstWord = tile % grid.columnTiles * grid.tileWords;
+    int words = std::min(grid.tileWords, grid.wordsPerRow - firstWord);
+    bool left = firstWord == 0;
+    bool right = firstWord + words == grid.wordsPerRow;
+    std::uint64_t leftMask = current.GetInteriorMask(0);
+    std::uint64_t rightMask = current.GetInteriorMask(grid.wordsPerRow - 1);
+
+    for (int y = firstRow; y < lastRow; y++) {
+        std::uint64_t* out = next.GetRow(y) + firstWord;
+        StepRowWords(nextState, current.GetRow(y - 1) + firstWord, current.GetRow(y) + firstWord,
+                     current.GetRow(y + 1) + firstWord, out, words);
+        if (left) {
+            out[0] &= leftMask;
+        }
+        if (right) {
+            out[words - 1] &= rightMask;
+        }
+    }
+}
+
+// The generation of every tile of a bounded board and the tiles ready to step. A step is queued
+// exactly once: whoever moves the tile's count of queued steps from g to g + 1 queues it.
+class TileSchedule {
+public:
+    TileSchedule(const TileGrid& grid, int generations)
+            : m_grid(grid), m_tiles(grid.GetCount()), m_generations(generations),
+              m_remaining(static_cast<long long>(grid.GetCount()) * generations) {
+        for (int tile = grid.GetCount() - 1; tile >= 0; tile--) {
+            offer(tile);
+        }
+    }
+
+    // a ready tile and the generation it is at, false once every tile has reached the last one
+    bool Take(int& tile, int& generation) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wake.wait(lock, [this] { return !m_ready.empty() || m_remaining == 0; });
+        if (m_ready.empty()) {
+            return false;
+        }
+        // the last tile queued is most often a neighbour of the one just stepped, still in cache
+        tile = m_ready.back();
+        m_ready.pop_back();
+        generation = m_tiles[tile].generation;
+        return true;
+    }
+
+    // after the tile has been stepped, queues it and the neighbours it was holding back
+    void Finish(int tile) {
+        m_tiles[tile].generation++;
+        int row = tile / m_grid.columnTiles;
+        int column = tile % m_grid.columnTiles;
+        for (int y = std::max(0, row - 1); y <= std::min(m_grid.rowTiles - 1, row + 1); y++) {
+            for (int x = std::max(0, column - 1); x <= std::min(m_grid.columnTiles - 1, column + 1); x++) {
+                offer(y * m_grid.columnTiles + x);
+            }
+        }
+        if (--m_remaining == 0) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_wake.notify_all();
+        }
+    }
+
+private:
+    struct Tile {
+        // generation the tile's cells are at
+        std::atomic<int> generation{0};
+        // steps of the tile queued so far
+        std::atomic<int> queued{0};
+    };
+
+    void offer(int tile) {
+        int generation = m_tiles[tile].generation;
+        if (generation >= m_generations) {
+            return;
+        }
+        int row = tile / m_grid.columnTiles;
+        int column = tile % m_grid.columnTiles;
+        for (int y = std::max(0, row - 1); y <= std::min(m_grid.rowTiles - 1, row + 1); y++) {
+            for (int x = std::max(0, column - 1); x <= std::min(m_grid.columnTiles - 1, column + 1); x++) {
+                if (m_tiles[y * m_grid.columnTiles + x].generation < generation) {
+                    return;
+                }
+            }
+        }
+        if (m_tiles[tile].queued.compare_exchange_strong(generation, generation + 1)) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_ready.push_back(tile);
+            m_wake.notify_one();
+        }
+    }
+
+    const TileGrid& m_grid;
+    std::vector<Tile> m_tiles;
+    int m_generations;
+    std::atomic<long long> m_remaining;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::vector<int> m_ready;
+};
+
+}
+
+DataflowEngine::DataflowEngine(const Rule& rule, int tileRows, int tileWords, int threadCount)
+        : Engine(rule), m_tileRows(std::max(1, tileRows)), m_tileWords(std::max(1, tileWords)), m_pool(threadCount) {
+}
+
+const char* DataflowEngine::GetName() const {
+    return "dataflow";
+}
+
+void DataflowEngine::Step(const Board& current, Board& next) {
+    GOL_TRACE_SCOPE("DataflowEngine::Step");
+    TileGrid grid(current, m_tileRows, m_tileWords);
+
+    VisitRuleKernel(m_rule, [&](const auto& kernel) {
+        m_pool.ParallelFor(grid.GetCount(), [&](int begin, int end) {
+            for (int tile = begin; tile < end; tile++) {
+                stepTile(kernel, grid, current, next, tile);
+            }
+        });
+    });
+
+    next.RefreshHalo();
+}
+
+void DataflowEngine::Advance(Board& current, Board& next, int generations) {
+    if (current.GetTopology() != Topology::Bounded || generations <= 0) {
+        Engine::Advance(current, next, generations);
+        return;
+    }
+
+    GOL_TRACE_SCOPE("DataflowEngine::Advance");
+    // the tiles read the ghost rows of both boards and never write them
+    next.RefreshHalo();
+    TileGrid grid(current, m_tileRows, m_tileWords);
+    TileSchedule schedule(grid, generations);
+    Board* boards[2] = {&current, &next};
+
+    VisitRuleKernel(m_rule, [&](const auto& kernel) {
+        // every thread takes ready tiles until the last generation, the pool runs one loop per thread
+        m_pool.ParallelFor(m_pool.GetThreadCount(), [&](int, int) {
+            int tile;
+            int generation;
+            while (schedule.Take(tile, generation)) {
+                stepTile(kernel, grid, *boards[generation % 2], *boards[1 - generation % 2], tile);
+                schedule.Finish(tile);
+            }
+        });
+    });
+
+    if (generations % 2 == 1) {
+        std::swap(current, next);
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef GAME_OF_LIFE_DATAFLOW_ENGINE_H
+#define GAME_OF_LIFE_DATAFLOW_ENGINE_H
+
+#include "engine.h"
+#include "thread_pool.h"
+
+// Runs the bitwise kernel over tiles of the board that each keep their own generation. In
+// Advance a tile steps from generation g to g + 1 as soon as its eight neighbours have reached g,
+// rather than when the whole board has: the threads take whichever tiles are ready from a shared
+// queue, so no thread idles at a barrier waiting for the busiest tile of a generation, and quiet
+// regions of the board run ahead of busy ones.
+//
+// Neighbouring tiles are never more than a generation apart, which bounds the lag between any two
+// tiles by their distance in tiles and lets the two boards hold every other generation of each
+// tile in turn: once a tile's neighbours have reached g they have also read its cells of g - 1.
+// A board that wraps steps a generation at a time with the tiles split over the threads, the
+// halo is only refreshed for the whole board. Two-state rules only.
+class DataflowEngine : public Engine {
+public:
+    // threads in total, hardware concurrency when 0
+    explicit DataflowEngine(const Rule& rule, int tileRows = 64, int tileWords = 64, int threadCount = 0);
+
+    const char* GetName() const override;
+    void Step(const Board& current, Board& next) override;
+    void Advance(Board& current, Board& next, int generations) override;
+
+private:
+    int m_tileRows;
+    int m_tileWords;
+    ThreadPool m_pool;
+};
+
+#endif //GAME_OF_LIFE_DATAFLOW_ENGINE_H
@@ -0,0 +1,41 @@
+#ifndef GAME_OF_LIFE_ENGINE_H
+#define GAME_OF_LIFE_ENGINE_H
+
+#include <utility>
+
+#include "board.h"
+#include "rule.h"
+
+// Computes generations of a board. Engines may keep state between steps but must not
+// depend on it for correctness: any board of any size can be passed at any time.
+// The rule is fixed at construction so engines can specialize their kernels for it.
+class Engine {
+public:
+    explicit Engine(const Rule& rule) : m_rule(rule) {
+    }
+    virtual ~Engine() = default;
+
+    virtual const char* GetName() const = 0;
+
+    const Rule& GetRule() const {
+        return m_rule;
+    }
+
+    // writes the generation following current into next, both boards have the same size and
+    // topology; the halo of current must be up to date
+    virtual void Step(const Board& current, Board& next) = 0;
+
+    // advances current by that many generations, next is scratch of the same size and topology;
+    // engines that step several generations per pass over the board override it
+    virtual void Advance(Board& current, Board& next, int generations) {
+        for (int generation = 0; generation < generations; generation++) {
+            Step(current, next);
+            std::swap(current, next);
+        }
+    }
+
+protected:
+    Rule m_rule;
+};
+
+#endif //GAME_OF_LIFE_ENGINE_H
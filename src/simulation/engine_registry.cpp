@@ -0,0 +1,57 @@
+#include "engine_registry.h"
+#include "bitwise_engine.h"
+#include "dataflow_engine.h"
+#include "larger_than_life_engine.h"
+#include "lut_engine.h"
+#include "pipelined_engine.h"
+#include "reference_engine.h"
+#include "temporal_blocking_engine.h"
+
+namespace {
+
+struct EngineEntry {
+    const char* name;
+    std::unique_ptr<Engine> (*create)(const Rule& rule);
+    // runs Generations rules on boards with several state planes
+    bool multiState;
+    // runs rules on the 3x3 neighbourhood, Larger-than-Life rules or both
+    bool lifeLike;
+    bool largerThanLife;
+};
+
+template<typename EngineType>
+std::unique_ptr<Engine> create(const Rule& rule) {
+    return std::make_unique<EngineType>(rule);
+}
+
+const EngineEntry engines[] = {
+        {"reference", create<ReferenceEngine>, true, true, true},
+        {"bitwise", create<BitwiseEngine>, true, true, false},
+        {"lut", create<LutEngine>, false, true, false},
+        {"ltl", create<LargerThanLifeEngine>, true, false, true},
+        {"blocked", create<TemporalBlockingEngine>, false, true, false},
+        {"pipelined", create<PipelinedEngine>, false, true, false},
+        {"dataflow", create<DataflowEngine>, false, true, false},
+};
+
+}
+
+std::vector<std::string> GetEngineNames() {
+    std::vector<std::string> names;
+    for (const EngineEntry& entry : engines) {
+        names.emplace_back(entry.name);
+    }
+    return names;
+}
+
+std::unique_ptr<Engine> CreateEngine(const std::string& name, const Rule& rule) {
+    for (const EngineEntry& entry : engines) {
+        if (name == entry.name) {
+            if ((rule.states > 2 && !entry.multiState) || !(rule.radius > 1 ? entry.largerThanLife : entry.lifeLike)) {
+                return nullptr;
+            }
+            return entry.create(rule);
+        }
+    }
+    return nullptr;
+}
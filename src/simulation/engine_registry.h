@@ -0,0 +1,16 @@
+#ifndef GAME_OF_LIFE_ENGINE_REGISTRY_H
+#define GAME_OF_LIFE_ENGINE_REGISTRY_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "engine.h"
+
+// names of every engine CreateEngine knows, the reference engine first
+std::vector<std::string> GetEngineNames();
+
+// nullptr when there is no engine with that name or the engine cannot run the rule
+std::unique_ptr<Engine> CreateEngine(const std::string& name, const Rule& rule = ConwayRule);
+
+#endif //GAME_OF_LIFE_ENGINE_REGISTRY_H
@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <cmath>
+
+#include "fft.h"
+
+namespace {
+
+// adjacent spectrum columns transformed together, one cache line of every row
+const int columnBlock = 8;
+
+const double pi = 3.14159265358979323846;
+
+// std::complex multiplication handles infinities through a library call, the FFT has none
+inline std::complex<float> multiply(std::complex<float> a, std::complex<float> b) {
+    return {a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()};
+}
+
+std::complex<float> twiddle(int k, int size) {
+    double angle = -2 * pi * k / size;
+    return {static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle))};
+}
+
+}
+
+Fft::Fft(int size) : m_size(size) {
+    int bits = 0;
+    while ((1 << bits) < size) {
+        bits++;
+    }
+    for (int i = 0; i < size; i++) {
+        int reversed = 0;
+        for (int bit = 0; bit < bits; bit++) {
+            reversed |= ((i >> bit) & 1) << (bits - 1 - bit);
+        }
+        if (i < reversed) {
+            m_swaps.emplace_back(i, reversed);
+        }
+    }
+
+    // the twiddles of every stage one after the other, so the butterflies read them in order
+    for (int length = 2; length <= size; length *= 2) {
+        for (int j = 0; j < length / 2; j++) {
+            std::complex<float> w = twiddle(j, length);
+            m_twiddles.push_back(w);
+            m_inverseTwiddles.push_back(std::conj(w));
+        }
+    }
+}
+
+int Fft::GetSize() const {
+    return m_size;
+}
+
+void Fft::Forward(std::complex<float>* data) const {
+    transform(data, m_twiddles.data());
+}
+
+void Fft::Inverse(std::complex<float>* data) const {
+    transform(data, m_inverseTwiddles.data());
+}
+
+void Fft::transform(std::complex<float>* data, const std::complex<float>* twiddles) const {
+    for (const auto& swap : m_swaps) {
+        std::swap(data[swap.first], data[swap.second]);
+    }
+
+    // real and imaginary parts as plain floats, which the compiler vectorizes
+    auto* values = reinterpret_cast<float*>(data);
+    auto* stageTwiddles = reinterpret_cast<const float*>(twiddles);
+    for (int length = 2; length <= m_size; length *= 2) {
+        int half = length / 2;
+        for (int start = 0; start < m_size; start += length) {
+            float* even = values + 2 * start;
+            float* odd = values + 2 * (start + half);
+            for (int j = 0; j < half; j++) {
+                float wr = stageTwiddles[2 * j];
+                float wi = stageTwiddles[2 * j + 1];
+                float oddReal = odd[2 * j] * wr - odd[2 * j + 1] * wi;
+                float oddImaginary = odd[2 * j] * wi + odd[2 * j + 1] * wr;
+                float evenReal = even[2 * j];
+                float evenImaginary = even[2 * j + 1];
+                even[2 * j] = evenReal + oddReal;
+                even[2 * j + 1] = evenImaginary + oddImaginary;
+                odd[2 * j] = evenReal - oddReal;
+                odd[2 * j + 1] = evenImaginary - oddImaginary;
+            }
+        }
+        stageTwiddles += 2 * half;
+    }
+}
+
+RealFft2D::RealFft2D(int width, int height)
+        : m_width(width), m_height(height), m_rowFft(width / 2), m_columnFft(height),
+          m_spectrum(static_cast<size_t>(width / 2 + 1) * height) {
+    for (int k = 0; k <= width / 2; k++) {
+        m_rowTwiddles.push_back(twiddle(k, width));
+    }
+}
+
+int RealFft2D::GetWidth() const {
+    return m_width;
+}
+
+int RealFft2D::GetHeight() const {
+    return m_height;
+}
+
+int RealFft2D::GetSpectrumWidth() const {
+    return m_width / 2 + 1;
+}
+
+void RealFft2D::forwardRow(const float* input, std::complex<float>* spectrum) const {
+    // even cells as the real and odd cells as the imaginary parts of a half-length transform
+    int half = m_width / 2;
+    for (int k = 0; k < half; k++) {
+        spectrum[k] = {input[2 * k], input[2 * k + 1]};
+    }
+    m_rowFft.Forward(spectrum);
+
+    // Z[k] = E[k] + i O[k] with both E and O hermitian, X[k] = E[k] + W^k O[k]; k and half - k
+    // are split together in place
+    for (int k = 0; k <= half / 2; k++) {
+        int mirror = half - k;
+        std::complex<float> z = spectrum[k];
+        std::complex<float> zMirror = spectrum[mirror % half];
+
+        std::complex<float> even = (z + std::conj(zMirror)) * .5f;
+        std::complex<float> odd = multiply(z - std::conj(zMirror), {0.f, -.5f});
+        std::complex<float> evenMirror = (zMirror + std::conj(z)) * .5f;
+        std::complex<float> oddMirror = multiply(zMirror - std::conj(z), {0.f, -.5f});
+
+        spectrum[k] = even + multiply(m_rowTwiddles[k], odd);
+        spectrum[mirror] = evenMirror + multiply(m_rowTwiddles[mirror], oddMirror);
+    }
+}
+
+void RealFft2D::inverseRow(const std::complex<float>* spectrum, float* output, float scale) const {
+    int half = m_width / 2;
+    thread_local std::vector<std::complex<float>> packed;
+    packed.resize(half);
+
+    for (int k = 0; k < half; k++) {
+        std::complex<float> x = spectrum[k];
+        std::complex<float> xMirror = std::conj(spectrum[half - k]);
+        std::complex<float> even = (x + xMirror) * .5f;
+        std::complex<float> odd = multiply((x - xMirror) * .5f, std::conj(m_rowTwiddles[k]));
+        packed[k] = even + multiply(odd, {0.f, 1.f});
+    }
+    m_rowFft.Inverse(packed.data());
+
+    for (int k = 0; k < half; k++) {
+        output[2 * k] = packed[k].real() * scale;
+        output[2 * k + 1] = packed[k].imag() * scale;
+    }
+}
+
+void RealFft2D::forwardRows(const float* input, int rowCount, ThreadPool& pool) {
+    int spectrumWidth = GetSpectrumWidth();
+    pool.ParallelFor(m_height, [&](int begin, int end) {
+        for (int y = begin; y < end; y++) {
+            std::complex<float>* row = &m_spectrum[static_cast<size_t>(y) * spectrumWidth];
+            if (y < rowCount) {
+                forwardRow(input + static_cast<size_t>(y) * m_width, row);
+            } else {
+                std::fill(row, row + spectrumWidth, std::complex<float>());
+            }
+        }
+    });
+}
+
+void RealFft2D::transformColumns(int begin, int end, const float* kernelSpectrum) {
+    int spectrumWidth = GetSpectrumWidth();
+    thread_local std::vector<std::complex<float>> columns;
+    columns.resize(static_cast<size_t>(columnBlock) * m_height);
+
+    for (int first = begin; first < end; first += columnBlock) {
+        int count = std::min(columnBlock, end - first);
+        for (int y = 0; y < m_height; y++) {
+            const std::complex<float>* row = &m_spectrum[static_cast<size_t>(y) * spectrumWidth + first];
+            for (int c = 0; c < count; c++) {
+                columns[static_cast<size_t>(c) * m_height + y] = row[c];
+            }
+        }
+
+        for (int c = 0; c < count; c++) {
+            std::complex<float>* column = &columns[static_cast<size_t>(c) * m_height];
+            m_columnFft.Forward(column);
+            if (kernelSpectrum != nullptr) {
+                for (int y = 0; y < m_height; y++) {
+                    column[y] *= kernelSpectrum[static_cast<size_t>(y) * spectrumWidth + first + c];
+                }
+                m_columnFft.Inverse(column);
+            }
+        }
+
+        for (int y = 0; y < m_height; y++) {
+            std::complex<float>* row = &m_spectrum[static_cast<size_t>(y) * spectrumWidth + first];
+            for (int c = 0; c < count; c++) {
+                row[c] = columns[static_cast<size_t>(c) * m_height + y];
+            }
+        }
+    }
+}
+
+void RealFft2D::Forward(const float* input, int rowCount, std::complex<float>* spectrum, ThreadPool& pool) {
+    forwardRows(input, rowCount, pool);
+    int blocks = (GetSpectrumWidth() + columnBlock - 1) / columnBlock;
+    pool.ParallelFor(blocks, [&](int begin, int end) {
+        transformColumns(begin * columnBlock, std::min(GetSpectrumWidth(), end * columnBlock), nullptr);
+    });
+    std::copy(m_spectrum.begin(), m_spectrum.end(), spectrum);
+}
+
+void RealFft2D::Convolve(const float* input, const float* kernelSpectrum, float* output, int rowCount,
+                         ThreadPool& pool) {
+    forwardRows(input, rowCount, pool);
+    int blocks = (GetSpectrumWidth() + columnBlock - 1) / columnBlock;
+    pool.ParallelFor(blocks, [&](int begin, int end) {
+        transformColumns(begin * columnBlock, std::min(GetSpectrumWidth(), end * columnBlock), kernelSpectrum);
+    });
+
+    // the column transforms scale by height, the half-length row transforms by width / 2
+    float scale = 2.f / (static_cast<float>(m_width) * static_cast<float>(m_height));
+    int spectrumWidth = GetSpectrumWidth();
+    pool.ParallelFor(rowCount, [&](int begin, int end) {
+        for (int y = begin; y < end; y++) {
+            inverseRow(&m_spectrum[static_cast<size_t>(y) * spectrumWidth], output + static_cast<size_t>(y) * m_width,
+                       scale);
+        }
+    });
+}
@@ -0,0 +1,68 @@
+#ifndef GAME_OF_LIFE_FFT_H
+#define GAME_OF_LIFE_FFT_H
+
+#include <complex>
+#include <vector>
+
+#include "thread_pool.h"
+
+// Radix-2 complex FFT of a power of two size with precomputed twiddles and bit reversal.
+// Unnormalized: Inverse(Forward(x)) is size * x.
+class Fft {
+public:
+    explicit Fft(int size);
+
+    int GetSize() const;
+
+    void Forward(std::complex<float>* data) const;
+    void Inverse(std::complex<float>* data) const;
+
+private:
+    void transform(std::complex<float>* data, const std::complex<float>* twiddles) const;
+
+    int m_size;
+    // pairs of indices the bit reversal swaps
+    std::vector<std::pair<int, int>> m_swaps;
+    // e^(-2 pi i j / length) for j < length / 2 of every stage, and their conjugates
+    std::vector<std::complex<float>> m_twiddles;
+    std::vector<std::complex<float>> m_inverseTwiddles;
+};
+
+// 2D FFT of a real width x height field, both powers of two and at least 2, stored row-major.
+// The spectrum keeps the width / 2 + 1 non-redundant columns of every row: rows are transformed
+// as half-length complex FFTs of their even and odd cells, then the columns in blocks of adjacent
+// ones so every row of the spectrum is read a cache line at a time. Rows and column blocks are
+// spread over the threads of the pool.
+class RealFft2D {
+public:
+    RealFft2D(int width, int height);
+
+    int GetWidth() const;
+    int GetHeight() const;
+    int GetSpectrumWidth() const;
+
+    // spectrum of the input; rows from rowCount on are taken as zero and not read
+    void Forward(const float* input, int rowCount, std::complex<float>* spectrum, ThreadPool& pool);
+
+    // circular convolution of the input with the field whose spectrum is given. The spectrum must
+    // be real, that of a kernel symmetric about the origin. Only the first rowCount rows of the
+    // input are read and of the output written.
+    void Convolve(const float* input, const float* kernelSpectrum, float* output, int rowCount, ThreadPool& pool);
+
+private:
+    void forwardRow(const float* input, std::complex<float>* spectrum) const;
+    void inverseRow(const std::complex<float>* spectrum, float* output, float scale) const;
+    void forwardRows(const float* input, int rowCount, ThreadPool& pool);
+    // columns [begin, end) through the column transform and, when the kernel is given, back
+    void transformColumns(int begin, int end, const float* kernelSpectrum);
+
+    int m_width;
+    int m_height;
+    Fft m_rowFft;
+    Fft m_columnFft;
+    // e^(-2 pi i k / width) for k <= width / 2, to split the half-length row transforms
+    std::vector<std::complex<float>> m_rowTwiddles;
+    std::vector<std::complex<float>> m_spectrum;
+};
+
+#endif //GAME_OF_LIFE_FFT_H
@@ -0,0 +1,54 @@
+#include "history.h"
+#include "../profiling/trace.h"
+
+History::History(size_t byteBudget) : m_byteBudget(byteBudget), m_byteSize(0), m_deltas(), m_generation(0) {
+}
+
+void History::Record(const Universe& universe) {
+    GOL_TRACE_SCOPE("History::Record");
+    if (universe.GetGeneration() == 0) {
+        return;
+    }
+    if (!m_deltas.empty() && universe.GetGeneration() != m_generation + 1) {
+        // the board was replaced or stepped without us, older deltas no longer apply
+        Clear();
+    }
+
+    m_deltas.push_back(universe.GetLastDelta());
+    m_byteSize += m_deltas.back().GetByteSize();
+    m_generation = universe.GetGeneration();
+
+    while (m_byteSize > m_byteBudget && !m_deltas.empty()) {
+        m_byteSize -= m_deltas.front().GetByteSize();
+        m_deltas.pop_front();
+    }
+}
+
+bool History::StepBack(Universe& universe) {
+    if (m_deltas.empty() || universe.GetGeneration() != m_generation) {
+        return false;
+    }
+
+    universe.Rewind(m_deltas.back());
+    m_byteSize -= m_deltas.back().GetByteSize();
+    m_deltas.pop_back();
+    m_generation--;
+    return true;
+}
+
+void History::Clear() {
+    m_deltas.clear();
+    m_byteSize = 0;
+}
+
+size_t History::GetSize() const {
+    return m_deltas.size();
+}
+
+size_t History::GetByteSize() const {
+    return m_byteSize;
+}
+
+size_t History::GetByteBudget() const {
+    return m_byteBudget;
+}
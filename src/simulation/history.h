@@ -0,0 +1,36 @@
+#ifndef GAME_OF_LIFE_HISTORY_H
+#define GAME_OF_LIFE_HISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+#include "universe.h"
+
+// Recent generations of a universe kept as XOR deltas within a fixed memory budget,
+// the oldest ones are dropped first. Stepping back costs O(changed tiles).
+class History {
+public:
+    explicit History(size_t byteBudget);
+
+    // remembers the step the universe has just made
+    void Record(const Universe& universe);
+
+    // restores the previous generation, false when there is nothing left to undo
+    bool StepBack(Universe& universe);
+
+    void Clear();
+
+    size_t GetSize() const;
+    size_t GetByteSize() const;
+    size_t GetByteBudget() const;
+
+private:
+    size_t m_byteBudget;
+    size_t m_byteSize;
+    std::deque<UniverseDelta> m_deltas;
+    // generation the newest delta leads to, used to detect steps that were not recorded
+    std::uint64_t m_generation;
+};
+
+#endif //GAME_OF_LIFE_HISTORY_H
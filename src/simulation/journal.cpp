@@ -0,0 +1,295 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include "journal.h"
+#include "board_delta.h"
+#include "../profiling/trace.h"
+
+namespace {
+
+const char journalMagic[4] = {'G', 'O', 'L', 'J'};
+const std::uint32_t journalVersion = 2;
+// headers of version 1 journals stop before the plane count
+const size_t journalHeaderV1Size = offsetof(JournalFileHeader, planeCount);
+const int maxPlaneCount = 8;
+
+}
+
+JournalWriter::JournalWriter(const std::string& path, const Board& board, std::uint64_t keyframeInterval)
+        : m_file(path, std::ios::binary | std::ios::trunc), m_header{}, m_keyframeInterval(keyframeInterval),
+          m_empty(true), m_lastGeneration(0), m_lastKeyframe(0) {
+    std::memcpy(m_header.magic, journalMagic, sizeof(journalMagic));
+    m_header.version = journalVersion;
+    m_header.width = board.GetWidth();
+    m_header.height = board.GetHeight();
+    m_header.keyframeInterval = keyframeInterval;
+    m_header.planeCount = static_cast<std::uint32_t>(board.GetPlaneCount());
+    m_header.topology = static_cast<std::uint32_t>(board.GetTopology());
+    if (!m_file) {
+        std::cout << "ERROR::JOURNAL: Failed to open " << path << std::endl;
+        return;
+    }
+    m_file.write(reinterpret_cast<const char*>(&m_header), sizeof(m_header));
+}
+
+bool JournalWriter::IsOpen() const {
+    return m_file.is_open() && m_file.good();
+}
+
+bool JournalWriter::Record(const Board& previous, const Board& current, std::uint64_t generation) {
+    GOL_TRACE_SCOPE("JournalWriter::Record");
+    if (!matchesHeader(previous) || !matchesHeader(current)) {
+        return false;
+    }
+    bool consecutive = !m_empty && generation == m_lastGeneration + 1;
+
+    if (consecutive) {
+        std::ostringstream payload;
+        BoardDelta::Between(previous, current).Write(payload);
+        if (!writeRecord(JournalRecordType::Delta, generation, payload.str())) {
+            return false;
+        }
+        m_stats.deltas++;
+        m_stats.deltaBytes += payload.tellp();
+    }
+
+    m_lastGeneration = generation;
+    m_empty = false;
+
+    if (!consecutive || m_keyframeInterval == 0 || generation - m_lastKeyframe >= m_keyframeInterval) {
+        return RecordKeyframe(current, generation);
+    }
+    return true;
+}
+
+bool JournalWriter::RecordKeyframe(const Board& board, std::uint64_t generation) {
+    if (!matchesHeader(board)) {
+        return false;
+    }
+    std::string payload;
+    size_t rowBytes = sizeof(std::uint64_t) * board.GetWordsPerRow();
+    payload.reserve(rowBytes * board.GetHeight() * board.GetPlaneCount());
+    for (int plane = 0; plane < board.GetPlaneCount(); plane++) {
+        for (int y = 0; y < board.GetHeight(); y++) {
+            payload.append(reinterpret_cast<const char*>(board.GetRow(y, plane)), rowBytes);
+        }
+    }
+
+    if (!writeRecord(JournalRecordType::Keyframe, generation, payload)) {
+        return false;
+    }
+    m_stats.keyframes++;
+    m_stats.keyframeBytes += payload.size();
+
+    m_lastGeneration = generation;
+    m_lastKeyframe = generation;
+    m_empty = false;
+    return true;
+}
+
+void JournalWriter::Flush() {
+    m_file.flush();
+}
+
+JournalStats JournalWriter::GetStats() const {
+    return m_stats;
+}
+
+bool JournalWriter::writeRecord(JournalRecordType type, std::uint64_t generation, const std::string& payload) {
+    JournalRecordHeader header{type, static_cast<std::uint32_t>(payload.size()), generation};
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_file.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+    if (!m_file) {
+        std::cout << "ERROR::JOURNAL: Failed to write generation " << generation << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool JournalWriter::matchesHeader(const Board& board) const {
+    if (board.GetWidth() != m_header.width || board.GetHeight() != m_header.height
+        || board.GetPlaneCount() != static_cast<int>(m_header.planeCount)
+        || board.GetTopology() != static_cast<Topology>(m_header.topology)) {
+        std::cout << "ERROR::JOURNAL: Board does not match the journal" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+JournalReader::JournalReader(const std::string& path)
+        : m_file(path, std::ios::binary), m_header{}, m_open(false), m_firstGeneration(0), m_generation(0),
+          m_positioned(false) {
+    m_header.planeCount = 1;
+    std::streamoff offset = journalHeaderV1Size;
+    m_file.read(reinterpret_cast<char*>(&m_header), journalHeaderV1Size);
+    if (m_file && m_header.version == journalVersion) {
+        m_file.read(reinterpret_cast<char*>(&m_header) + journalHeaderV1Size, sizeof(m_header) - journalHeaderV1Size);
+        offset = sizeof(m_header);
+    }
+    if (!m_file || std::memcmp(m_header.magic, journalMagic, sizeof(journalMagic)) != 0
+        || m_header.version < 1 || m_header.version > journalVersion || m_header.width < 0 || m_header.height < 0
+        || m_header.planeCount < 1 || m_header.planeCount > maxPlaneCount
+        || m_header.topology > static_cast<std::uint32_t>(Topology::KleinBottle)) {
+        std::cout << "ERROR::JOURNAL: Not a journal file " << path << std::endl;
+        return;
+    }
+
+    m_file.seekg(0, std::ios::end);
+    std::streamoff fileSize = m_file.tellg();
+
+    // index the records; a record cut short by a crash ends the journal
+    JournalRecordHeader record{};
+    while (offset + static_cast<std::streamoff>(sizeof(record)) <= fileSize) {
+        m_file.seekg(offset);
+        m_file.read(reinterpret_cast<char*>(&record), sizeof(record));
+        std::streamoff payload = offset + sizeof(record);
+        if (!m_file || payload + record.size > fileSize) {
+            break;
+        }
+
+        if (m_entries.empty()) {
+            m_firstGeneration = record.generation;
+        }
+        if (record.generation < m_firstGeneration) {
+            break;
+        }
+        size_t index = record.generation - m_firstGeneration;
+        if (index >= m_entries.size()) {
+            m_entries.resize(index + 1);
+        }
+        if (record.type == JournalRecordType::Keyframe) {
+            m_entries[index].keyframe = payload;
+        } else {
+            m_entries[index].delta = payload;
+        }
+        offset = payload + record.size;
+    }
+
+    m_file.clear();
+    m_board = Board(m_header.width, m_header.height, static_cast<int>(m_header.planeCount));
+    m_board.SetTopology(static_cast<Topology>(m_header.topology));
+    m_open = !m_entries.empty();
+}
+
+bool JournalReader::IsOpen() const {
+    return m_open;
+}
+
+int JournalReader::GetWidth() const {
+    return m_header.width;
+}
+
+int JournalReader::GetHeight() const {
+    return m_header.height;
+}
+
+int JournalReader::GetPlaneCount() const {
+    return static_cast<int>(m_header.planeCount);
+}
+
+Topology JournalReader::GetTopology() const {
+    return static_cast<Topology>(m_header.topology);
+}
+
+std::uint64_t JournalReader::GetFirstGeneration() const {
+    return m_firstGeneration;
+}
+
+std::uint64_t JournalReader::GetLastGeneration() const {
+    return m_firstGeneration + m_entries.size() - 1;
+}
+
+bool JournalReader::Seek(std::uint64_t generation, Board& board) {
+    GOL_TRACE_SCOPE("JournalReader::Seek");
+    if (!m_open || generation < m_firstGeneration || generation > GetLastGeneration()) {
+        return false;
+    }
+
+    std::int64_t keyframe = static_cast<std::int64_t>(generation - m_firstGeneration);
+    while (keyframe >= 0 && m_entries[keyframe].keyframe < 0) {
+        keyframe--;
+    }
+    std::int64_t keyframeDistance = keyframe < 0 ? -1 : static_cast<std::int64_t>(generation - m_firstGeneration) - keyframe;
+    std::int64_t distance = cursorDistance(generation);
+
+    if (distance < 0 || (keyframeDistance >= 0 && keyframeDistance < distance)) {
+        if (keyframe < 0 || !loadKeyframe(m_firstGeneration + keyframe)) {
+            return false;
+        }
+    }
+
+    while (m_generation < generation) {
+        if (!applyDelta(m_generation + 1)) {
+            return false;
+        }
+        m_generation++;
+    }
+    while (m_generation > generation) {
+        if (!applyDelta(m_generation)) {
+            return false;
+        }
+        m_generation--;
+    }
+
+    // the deltas leave the ghost cells of wrapping boards behind
+    m_board.RefreshHalo();
+    board = m_board;
+    return true;
+}
+
+bool JournalReader::loadKeyframe(std::uint64_t generation) {
+    m_positioned = false;
+    m_file.seekg(m_entries[generation - m_firstGeneration].keyframe);
+
+    auto rowBytes = static_cast<std::streamsize>(sizeof(std::uint64_t) * m_board.GetWordsPerRow());
+    for (int plane = 0; plane < m_board.GetPlaneCount(); plane++) {
+        for (int y = 0; y < m_board.GetHeight(); y++) {
+            m_file.read(reinterpret_cast<char*>(m_board.GetRow(y, plane)), rowBytes);
+        }
+    }
+    if (!m_file) {
+        std::cout << "ERROR::JOURNAL: Failed to read keyframe " << generation << std::endl;
+        m_file.clear();
+        return false;
+    }
+
+    m_board.RefreshHalo();
+    m_generation = generation;
+    m_positioned = true;
+    return true;
+}
+
+bool JournalReader::applyDelta(std::uint64_t generation) {
+    std::int64_t offset = m_entries[generation - m_firstGeneration].delta;
+    BoardDelta delta;
+    if (offset >= 0) {
+        m_file.seekg(offset);
+    }
+    if (offset < 0 || !delta.Read(m_file) || !delta.Fits(m_board)) {
+        std::cout << "ERROR::JOURNAL: Failed to read delta " << generation << std::endl;
+        m_file.clear();
+        m_positioned = false;
+        return false;
+    }
+
+    delta.ApplyTo(m_board);
+    return true;
+}
+
+std::int64_t JournalReader::cursorDistance(std::uint64_t target) const {
+    if (!m_positioned) {
+        return -1;
+    }
+
+    std::uint64_t low = std::min(target, m_generation);
+    std::uint64_t high = std::max(target, m_generation);
+    for (std::uint64_t generation = low + 1; generation <= high; generation++) {
+        if (m_entries[generation - m_firstGeneration].delta < 0) {
+            return -1;
+        }
+    }
+    return static_cast<std::int64_t>(high - low);
+}
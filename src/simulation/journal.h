@@ -0,0 +1,115 @@
+#ifndef GAME_OF_LIFE_JOURNAL_H
+#define GAME_OF_LIFE_JOURNAL_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "board.h"
+
+// Append-only journal of a run: a delta per generation plus a full keyframe every
+// keyframeInterval generations, so any generation can be restored without re-simulating.
+//
+// File layout: JournalFileHeader, then records of JournalRecordHeader followed by size bytes
+// of payload. A keyframe payload is the board rows of every state plane as in a board file, a
+// delta payload is a BoardDelta that turns generation - 1 into generation. Keyframe generations
+// also get a delta so the journal can be walked backwards through them.
+// Version 1 headers end before planeCount, those journals have one plane and are bounded.
+struct JournalFileHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::int32_t width;
+    std::int32_t height;
+    std::uint64_t keyframeInterval;
+    std::uint32_t planeCount;
+    std::uint32_t topology;
+};
+
+enum class JournalRecordType : std::uint32_t {
+    Keyframe = 1,
+    Delta = 2
+};
+
+struct JournalRecordHeader {
+    JournalRecordType type;
+    std::uint32_t size;
+    std::uint64_t generation;
+};
+
+struct JournalStats {
+    std::uint64_t keyframes = 0;
+    std::uint64_t deltas = 0;
+    std::uint64_t keyframeBytes = 0;
+    std::uint64_t deltaBytes = 0;
+};
+
+class JournalWriter {
+public:
+    // every recorded board has the size, state planes and topology of board
+    JournalWriter(const std::string& path, const Board& board, std::uint64_t keyframeInterval);
+
+    bool IsOpen() const;
+
+    // appends current as generation; previous must be generation - 1, the first generation
+    // and every keyframeInterval generations after the last keyframe are also stored in full
+    bool Record(const Board& previous, const Board& current, std::uint64_t generation);
+    bool RecordKeyframe(const Board& board, std::uint64_t generation);
+
+    void Flush();
+
+    JournalStats GetStats() const;
+
+private:
+    bool writeRecord(JournalRecordType type, std::uint64_t generation, const std::string& payload);
+    bool matchesHeader(const Board& board) const;
+
+    std::ofstream m_file;
+    JournalFileHeader m_header;
+    std::uint64_t m_keyframeInterval;
+    bool m_empty;
+    std::uint64_t m_lastGeneration;
+    std::uint64_t m_lastKeyframe;
+    JournalStats m_stats;
+};
+
+class JournalReader {
+public:
+    explicit JournalReader(const std::string& path);
+
+    bool IsOpen() const;
+
+    int GetWidth() const;
+    int GetHeight() const;
+    int GetPlaneCount() const;
+    Topology GetTopology() const;
+    std::uint64_t GetFirstGeneration() const;
+    std::uint64_t GetLastGeneration() const;
+
+    // restores the board at generation from the nearest keyframe at or before it, or from the
+    // previously sought generation when that is closer (deltas apply in both directions)
+    bool Seek(std::uint64_t generation, Board& board);
+
+private:
+    struct Entry {
+        std::int64_t keyframe = -1;
+        std::int64_t delta = -1;
+    };
+
+    bool loadKeyframe(std::uint64_t generation);
+    bool applyDelta(std::uint64_t generation);
+    // cost of reaching target from the cursor, or -1 when a delta on the way is missing
+    std::int64_t cursorDistance(std::uint64_t target) const;
+
+    std::ifstream m_file;
+    JournalFileHeader m_header;
+    bool m_open;
+    std::uint64_t m_firstGeneration;
+    std::vector<Entry> m_entries;
+
+    Board m_board;
+    std::uint64_t m_generation;
+    bool m_positioned;
+};
+
+#endif //GAME_OF_LIFE_JOURNAL_H
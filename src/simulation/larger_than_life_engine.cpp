@@ -0,0 +1,134 @@
+#include <algorithm>
+
+#include "larger_than_life_engine.h"
+#include "bit_kernel.h"
+
+namespace {
+
+// the live cells of row y one byte each
+void unpackAlive(const Board& board, int y, std::uint8_t* cells) {
+    for (int x = 0; x < board.GetWidth();) {
+        int bit = x + 1;
+        std::uint64_t word = board.GetAliveWord(y, bit / 64) >> (bit % 64);
+        for (int end = std::min(board.GetWidth(), x + 64 - bit % 64); x < end; x++) {
+            cells[x] = static_cast<std::uint8_t>(word & 1);
+            word >>= 1;
+        }
+    }
+}
+
+}
+
+LargerThanLifeEngine::LargerThanLifeEngine(const Rule& rule) : Engine(rule) {
+}
+
+const char* LargerThanLifeEngine::GetName() const {
+    return "ltl";
+}
+
+void LargerThanLifeEngine::sumRow(const Board& board, int y, std::uint16_t* sums) {
+    int width = board.GetWidth();
+    int radius = m_rule.radius;
+    bool mirrored;
+    if (!WrapRow(board.GetTopology(), board.GetHeight(), y, mirrored)) {
+        std::fill(sums, sums + width, 0);
+        return;
+    }
+    std::uint8_t* cells = m_cells.data() + radius;
+    unpackAlive(board, y, cells);
+    if (mirrored) {
+        std::reverse(cells, cells + width);
+    }
+    // the padding stays dead around bounded boards, otherwise it holds the cells of the other end
+    if (board.GetTopology() != Topology::Bounded) {
+        for (int i = 1; i <= radius; i++) {
+            cells[-i] = cells[((-i) % width + width) % width];
+            cells[width - 1 + i] = cells[(i - 1) % width];
+        }
+    }
+
+    // cells [x - R, x + R] of the row
+    std::uint16_t sum = 0;
+    for (int i = 0; i < 2 * radius; i++) {
+        sum = static_cast<std::uint16_t>(sum + m_cells[i]);
+    }
+    for (int x = 0; x < width; x++) {
+        sum = static_cast<std::uint16_t>(sum + m_cells[x + 2 * radius]);
+        sums[x] = sum;
+        sum = static_cast<std::uint16_t>(sum - m_cells[x]);
+    }
+}
+
+void LargerThanLifeEngine::Step(const Board& current, Board& next) {
+    int width = current.GetWidth();
+    int height = current.GetHeight();
+    int wordsPerRow = current.GetWordsPerRow();
+    int radius = m_rule.radius;
+    int window = 2 * radius + 1;
+
+    m_cells.assign(width + 2 * radius, 0);
+    m_rowSums.assign(static_cast<size_t>(window) * width, 0);
+    m_boxSums.assign(width, 0);
+    m_alive.resize(width);
+    m_nextCells.resize(width);
+    m_nextAlive.resize(wordsPerRow);
+
+    // the window of the first row also holds the rows above the board, which are dead unless the
+    // board wraps around; row y goes into slot y mod (2R + 1)
+    bool bounded = current.GetTopology() == Topology::Bounded;
+    for (int y = bounded ? 0 : -radius; y < (bounded ? std::min(radius, height) : radius); y++) {
+        std::uint16_t* sums = &m_rowSums[static_cast<size_t>((y + window) % window) * width];
+        sumRow(current, y, sums);
+        for (int x = 0; x < width; x++) {
+            m_boxSums[x] = static_cast<std::uint16_t>(m_boxSums[x] + sums[x]);
+        }
+    }
+
+    // locals, byte stores may alias the members and would keep the compiler from vectorizing
+    int centre = m_rule.countsCentre ? 0 : 1;
+    int birthFirst = m_rule.birthRange.first;
+    int birthLast = m_rule.birthRange.last;
+    int survivalFirst = m_rule.survivalRange.first;
+    int survivalLast = m_rule.survivalRange.last;
+    const std::uint8_t* aliveCells = m_alive.data();
+    const std::uint16_t* boxSums = m_boxSums.data();
+    std::uint8_t* nextCells = m_nextCells.data();
+    for (int y = 0; y < height; y++) {
+        // row y + R enters the window in the slot of row y - R - 1, which leaves it
+        int entering = y + radius;
+        std::uint16_t* sums = &m_rowSums[static_cast<size_t>(entering % window) * width];
+        for (int x = 0; x < width; x++) {
+            m_boxSums[x] = static_cast<std::uint16_t>(m_boxSums[x] - sums[x]);
+        }
+        sumRow(current, entering, sums);
+        for (int x = 0; x < width; x++) {
+            m_boxSums[x] = static_cast<std::uint16_t>(m_boxSums[x] + sums[x]);
+        }
+
+        unpackAlive(current, y, m_alive.data());
+        for (int x = 0; x < width; x++) {
+            int alive = aliveCells[x];
+            int count = boxSums[x] - centre * alive;
+            int first = alive ? survivalFirst : birthFirst;
+            int last = alive ? survivalLast : birthLast;
+            nextCells[x] = static_cast<std::uint8_t>(count >= first && count <= last);
+        }
+
+        // packed a word at a time, in a register rather than through memory
+        for (int w = 0; w < wordsPerRow; w++) {
+            std::uint64_t word = 0;
+            for (int x = std::max(0, w * 64 - 1); x < std::min(width, w * 64 + 63); x++) {
+                word |= std::uint64_t(nextCells[x]) << ((x + 1) % 64);
+            }
+            m_nextAlive[w] = word;
+        }
+
+        if (m_rule.states > 2) {
+            StepGenerationsRow(current, next, y, m_nextAlive.data(), m_rule.states);
+        } else {
+            std::copy(m_nextAlive.begin(), m_nextAlive.end(), next.GetRow(y));
+        }
+    }
+
+    next.RefreshHalo();
+}
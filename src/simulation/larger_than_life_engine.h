@@ -0,0 +1,35 @@
+#ifndef GAME_OF_LIFE_LARGER_THAN_LIFE_ENGINE_H
+#define GAME_OF_LIFE_LARGER_THAN_LIFE_ENGINE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "engine.h"
+
+// Runs Larger-than-Life rules, counting the live cells of the box of radius R around every cell
+// with separable running sums: each row keeps the sums of the 2R + 1 cells around every column,
+// and a sum per column over the last 2R + 1 of those row sums is updated by one row entering and
+// one leaving the window. The cost per cell does not depend on the radius.
+class LargerThanLifeEngine : public Engine {
+public:
+    explicit LargerThanLifeEngine(const Rule& rule);
+
+    const char* GetName() const override;
+    void Step(const Board& current, Board& next) override;
+
+private:
+    void sumRow(const Board& board, int y, std::uint16_t* sums);
+
+    // live cells of a row, one byte each, with radius dead cells on both sides
+    std::vector<std::uint8_t> m_cells;
+    // horizontal sums of the 2R + 1 rows of the window, row y in slot y % (2R + 1)
+    std::vector<std::uint16_t> m_rowSums;
+    // live cells in the box around every cell of the current row
+    std::vector<std::uint16_t> m_boxSums;
+    // live cells and next live cells of the current row
+    std::vector<std::uint8_t> m_alive;
+    std::vector<std::uint8_t> m_nextCells;
+    std::vector<std::uint64_t> m_nextAlive;
+};
+
+#endif //GAME_OF_LIFE_LARGER_THAN_LIFE_ENGINE_H
@@ -0,0 +1,61 @@
+#ifndef GAME_OF_LIFE_LENIA_ENGINE_H
+#define GAME_OF_LIFE_LENIA_ENGINE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "continuous_board.h"
+#include "fft.h"
+#include "thread_pool.h"
+
+// Lenia, a continuous cellular automaton: a smooth ring-shaped kernel of the radius, summing to 1,
+// weighs the states around every cell into its potential u. The cell then moves by
+// timeStep * (2 * exp(-(u - growthMean)^2 / (2 * growthWidth^2)) - 1) and is clamped to [0, 1].
+// The defaults are those of Orbium.
+struct LeniaRule {
+    int radius = 13;
+    float growthMean = .15f;
+    float growthWidth = .015f;
+    float timeStep = .1f;
+};
+
+// "Lenia R13 mu0.15 sigma0.015 dt0.1"
+std::string FormatLeniaRule(const LeniaRule& rule);
+
+// weights of the (2 * radius + 1)^2 box around a cell, row-major from the top left
+std::vector<float> MakeLeniaKernel(const LeniaRule& rule);
+
+// Steps a ContinuousBoard with the convolution done by FFT: the cost per cell grows with the log
+// of the board size instead of with the kernel area. The board is zero padded to powers of two at
+// least radius larger, so the cells beyond the edges count as 0 as with the other engines; the
+// kernel spectrum for that size is kept until the board size changes.
+class LeniaEngine {
+public:
+    // threads in total, hardware concurrency when 0
+    explicit LeniaEngine(const LeniaRule& rule, int threadCount = 0);
+
+    LeniaEngine(const LeniaEngine&) = delete;
+    LeniaEngine& operator=(const LeniaEngine&) = delete;
+
+    const LeniaRule& GetRule() const;
+
+    // writes the generation following current into next, both boards have the same size
+    void Step(const ContinuousBoard& current, ContinuousBoard& next);
+
+private:
+    void prepare(int width, int height);
+
+    LeniaRule m_rule;
+    ThreadPool m_pool;
+    int m_width;
+    int m_height;
+    std::unique_ptr<RealFft2D> m_fft;
+    // real since the kernel is symmetric about the origin
+    std::vector<float> m_kernelSpectrum;
+    // the board zero padded to the transform size, and the potential of every cell in that layout
+    std::vector<float> m_input;
+    std::vector<float> m_potential;
+};
+
+#endif //GAME_OF_LIFE_LENIA_ENGINE_H
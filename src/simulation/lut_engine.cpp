@@ -0,0 +1,113 @@
+#include <vector>
+
+#include "lut_engine.h"
+
+namespace {
+
+// index bit 3 * row + column of a 3x3 neighbourhood, result is the next state of its centre
+constexpr std::array<std::uint8_t, 512> makeCellTable(const Rule& rule) {
+    std::array<std::uint8_t, 512> table{};
+    for (std::uint32_t i = 0; i < table.size(); i++) {
+        table[i] = NextState(rule, i);
+    }
+    return table;
+}
+
+// index bit 4 * row + column of a 4x4 neighbourhood, result bit 2 * row + column of the next
+// state of its centre block; composed from the 3x3 table, which keeps the Conway table close to
+// the compilers' constant evaluation budgets, CMake raises them the rest of the way
+constexpr std::array<std::uint8_t, 65536> makeBlockTable(const Rule& rule) {
+    std::array<std::uint8_t, 512> nextCells = makeCellTable(rule);
+    std::array<std::uint8_t, 65536> table{};
+    for (std::uint32_t i = 0; i < table.size(); i++) {
+        std::uint8_t block = 0;
+        for (int cell = 0; cell < 4; cell++) {
+            std::uint32_t origin = 4 * (cell / 2) + cell % 2;
+            std::uint32_t index = ((i >> origin) & 0x7) |
+                                  ((i >> (origin + 4)) & 0x7) << 3 |
+                                  ((i >> (origin + 8)) & 0x7) << 6;
+            block |= nextCells[index] << cell;
+        }
+        table[i] = block;
+    }
+    return table;
+}
+
+constexpr std::array<std::uint8_t, 65536> conwayBlocks = makeBlockTable(ConwayRule);
+
+static_assert(conwayBlocks[0x0000] == 0x0, "empty stays empty");
+static_assert(conwayBlocks[0x0660] == 0xF, "block is still");
+static_assert(conwayBlocks[0x0222] == 0x3, "blinker turns");
+
+// row bits shifted so that bit 0 is the cell left of the word, the neighbourhood of column
+// pair k then starts at bit 2k
+inline std::uint64_t extendLeft(const std::uint64_t* row, int w) {
+    return (row[w] << 1) | (row[w - 1] >> 63);
+}
+
+inline std::uint64_t extendRight(const std::uint64_t* row, int w) {
+    return (row[w] >> 63) | (row[w + 1] << 1);
+}
+
+}
+
+LutEngine::LutEngine(const Rule& rule) : Engine(rule), m_blocks(conwayBlocks.data()) {
+    if (rule != ConwayRule) {
+        m_ruleBlocks = std::make_unique<std::array<std::uint8_t, 65536>>(makeBlockTable(rule));
+        m_blocks = m_ruleBlocks->data();
+    }
+}
+
+const char* LutEngine::GetName() const {
+    return "lut";
+}
+
+void LutEngine::Step(const Board& current, Board& next) {
+    int height = current.GetHeight();
+    int wordsPerRow = current.GetWordsPerRow();
+
+    if (m_zeroRow.size() < static_cast<size_t>(wordsPerRow) + 2) {
+        m_zeroRow.resize(wordsPerRow + 2, 0);
+    }
+
+    for (int y = 0; y < height; y += 2) {
+        const std::uint64_t* rows[4] = {
+                current.GetRow(y - 1),
+                current.GetRow(y),
+                current.GetRow(y + 1),
+                y + 2 <= height ? current.GetRow(y + 2) : m_zeroRow.data() + 1
+        };
+        std::uint64_t* out0 = next.GetRow(y);
+        std::uint64_t* out1 = next.GetRow(y + 1);
+
+        for (int w = 0; w < wordsPerRow; w++) {
+            std::uint64_t low[4];
+            std::uint64_t high[4];
+            for (int r = 0; r < 4; r++) {
+                low[r] = extendLeft(rows[r], w);
+                high[r] = extendRight(rows[r], w);
+            }
+
+            std::uint64_t result0 = 0;
+            std::uint64_t result1 = 0;
+            for (int k = 0; k < 32; k++) {
+                std::uint32_t index = 0;
+                for (int r = 0; r < 4; r++) {
+                    // the last pair needs two bits of the next word
+                    std::uint64_t nibble = k < 31 ? (low[r] >> (2 * k)) & 0xF
+                                                  : (low[r] >> 62) | ((high[r] & 0x3) << 2);
+                    index |= static_cast<std::uint32_t>(nibble) << (4 * r);
+                }
+
+                std::uint64_t block = m_blocks[index];
+                result0 |= (block & 0x3) << (2 * k);
+                result1 |= (block >> 2) << (2 * k);
+            }
+
+            out0[w] = result0;
+            out1[w] = result1;
+        }
+    }
+
+    next.RefreshHalo();
+}
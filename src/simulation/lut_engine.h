@@ -0,0 +1,31 @@
+#ifndef GAME_OF_LIFE_LUT_ENGINE_H
+#define GAME_OF_LIFE_LUT_ENGINE_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "engine.h"
+
+// Steps the board in 2x2 blocks: the 4x4 neighbourhood of a block is a 16 bit index into a
+// 65536 entry table of the next generation of its centre. The B3/S23 table is generated at
+// compile time, other rules build theirs on construction.
+// Four lookups per output block replace all per-cell arithmetic, at the cost of 64 KB of cache;
+// a baseline for gol_bench against the bit-sliced engines.
+class LutEngine : public Engine {
+public:
+    explicit LutEngine(const Rule& rule);
+
+    const char* GetName() const override;
+    void Step(const Board& current, Board& next) override;
+
+private:
+    std::unique_ptr<std::array<std::uint8_t, 65536>> m_ruleBlocks;
+    const std::uint8_t* m_blocks;
+    // stands in for the row below the ghost row when the height is odd, with padding words; only
+    // ever read, so it stays zero as it grows
+    std::vector<std::uint64_t> m_zeroRow;
+};
+
+#endif //GAME_OF_LIFE_LUT_ENGINE_H
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <thread>
+
+#include "pipelined_engine.h"
+#include "bit_kernel.h"
+#include "../profiling/trace.h"
+
+namespace {
+
+// steps rows [first, last) and clears the cells of the first and last word that lie beyond the
+// edges of the board, which leaves a bounded board's halo right without a RefreshHalo
+template<typename Kernel>
+void stepBand(const Kernel& nextState, const Board& current, Board& next, int first, int last) {
+    int wordsPerRow = current.GetWordsPerRow();
+    std::uint64_t firstMask = current.GetInteriorMask(0);
+    std::uint64_t lastMask = current.GetInteriorMask(wordsPerRow - 1);
+    for (int y = first; y < last; y++) {
+        std::uint64_t* out = next.GetRow(y);
+        StepRowWords(nextState, current.GetRow(y - 1), current.GetRow(y), current.GetRow(y + 1), out, wordsPerRow);
+        out[0] &= firstMask;
+        out[wordsPerRow - 1] &= lastMask;
+    }
+}
+
+}
+
+PipelinedEngine::PipelinedEngine(const Rule& rule, int bandRows, int threadCount)
+        : Engine(rule), m_bandRows(std::max(1, bandRows)), m_pool(threadCount), m_progress(m_pool.GetThreadCount()) {
+}
+
+const char* PipelinedEngine::GetName() const {
+    return "pipelined";
+}
+
+void PipelinedEngine::Step(const Board& current, Board& next) {
+    GOL_TRACE_SCOPE("PipelinedEngine::Step");
+    int height = current.GetHeight();
+    int bands = (height + m_bandRows - 1) / m_bandRows;
+
+    VisitRuleKernel(m_rule, [&](const auto& kernel) {
+        m_pool.ParallelFor(bands, [&](int begin, int end) {
+            stepBand(kernel, current, next, begin * m_bandRows, std::min(end * m_bandRows, height));
+        });
+    });
+
+    next.RefreshHalo();
+}
+
+void PipelinedEngine::Advance(Board& current, Board& next, int generations) {
+    if (current.GetTopology() != Topology::Bounded) {
+        Engine::Advance(current, next, generations);
+        return;
+    }
+
+    // the pipeline reads the ghost rows of both boards and never writes them
+    next.RefreshHalo();
+    while (generations > 0) {
+        int stages = std::min(generations, m_pool.GetThreadCount());
+        pipeline(current, next, stages);
+        if (stages % 2 == 1) {
+            std::swap(current, next);
+        }
+        generations -= stages;
+    }
+}
+
+void PipelinedEngine::pipeline(Board& current, Board& next, int stages) {
+    GOL_TRACE_SCOPE("PipelinedEngine::pipeline");
+    int height = current.GetHeight();
+    Board* boards[2] = {&current, &next};
+    for (int stage = 0; stage < stages; stage++) {
+        m_progress[stage].rows.store(0, std::memory_order_relaxed);
+    }
+
+    VisitRuleKernel(m_rule, [&](const auto& kernel) {
+        // the pool hands out the stages in order a stage at a time, so the stage a thread waits for
+        // has been taken by a thread that is running it
+        m_pool.ParallelFor(stages, [&](int begin, int end) {
+            for (int stage = begin; stage < end; stage++) {
+                const Board& source = *boards[stage % 2];
+                Board& target = *boards[1 - stage % 2];
+                for (int first = 0; first < height; first += m_bandRows) {
+                    int last = std::min(first + m_bandRows, height);
+                    // the generation before has written every row the band reads and has read the
+                    // rows of the generation two back that the band overwrites
+                    int needed = std::min(last + 1, height);
+                    while (stage > 0 && m_progress[stage - 1].rows.load(std::memory_order_acquire) < needed) {
+                        std::this_thread::yield();
+                    }
+                    stepBand(kernel, source, target, first, last);
+                    m_progress[stage].rows.store(last, std::memory_order_release);
+                }
+            }
+        });
+    });
+}
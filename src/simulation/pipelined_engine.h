@@ -0,0 +1,44 @@
+#ifndef GAME_OF_LIFE_PIPELINED_ENGINE_H
+#define GAME_OF_LIFE_PIPELINED_ENGINE_H
+
+#include <atomic>
+#include <vector>
+
+#include "engine.h"
+#include "thread_pool.h"
+
+// Runs the bitwise kernel as a wavefront: Advance gives every thread a generation of its own,
+// and each one sweeps the board band of rows by band of rows a little behind the thread on the
+// generation before it. A thread only waits for the rows it reads to be written by the one ahead
+// and no barrier separates the generations, so a band is stepped by all of them while it is still
+// in the shared cache. The two boards hold every other generation in turn: writing rows of the
+// generation two back is safe once the thread ahead has read them, the same rows it waits for.
+//
+// A board that wraps top to bottom makes every generation wait for the last row of the one
+// before, those step a generation at a time with the bands split over the threads. Two-state
+// rules only.
+class PipelinedEngine : public Engine {
+public:
+    // threads in total, hardware concurrency when 0
+    explicit PipelinedEngine(const Rule& rule, int bandRows = 16, int threadCount = 0);
+
+    const char* GetName() const override;
+    void Step(const Board& current, Board& next) override;
+    void Advance(Board& current, Board& next, int generations) override;
+
+private:
+    // on its own cache line, the threads behind poll it
+    struct alignas(64) Progress {
+        // rows of the stage's generation written so far
+        std::atomic<int> rows{0};
+    };
+
+    // the generations after current, current and next in turn, one stage per thread
+    void pipeline(Board& current, Board& next, int stages);
+
+    int m_bandRows;
+    ThreadPool m_pool;
+    std::vector<Progress> m_progress;
+};
+
+#endif //GAME_OF_LIFE_PIPELINED_ENGINE_H
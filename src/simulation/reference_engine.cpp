@@ -0,0 +1,53 @@
+#include "reference_engine.h"
+
+ReferenceEngine::ReferenceEngine(const Rule& rule) : Engine(rule) {
+}
+
+const char* ReferenceEngine::GetName() const {
+    return "reference";
+}
+
+void ReferenceEngine::Step(const Board& current, Board& next) {
+    int width = current.GetWidth();
+    int height = current.GetHeight();
+    Topology topology = current.GetTopology();
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            bool nextAlive;
+            if (m_rule.radius > 1) {
+                // the box reaches further than the halo, the cells beyond the edges are looked up
+                // one by one
+                int count = 0;
+                for (int dy = -m_rule.radius; dy <= m_rule.radius; dy++) {
+                    for (int dx = -m_rule.radius; dx <= m_rule.radius; dx++) {
+                        bool counted = (dx != 0 || dy != 0) || m_rule.countsCentre;
+                        int cellX = x + dx;
+                        int cellY = y + dy;
+                        bool mirrored;
+                        bool inside = WrapRow(topology, height, cellY, mirrored);
+                        if (topology == Topology::Bounded) {
+                            inside = inside && cellX >= 0 && cellX < width;
+                        } else {
+                            cellX = ((mirrored ? width - 1 - cellX : cellX) % width + width) % width;
+                        }
+                        count += inside && counted && current.Get(cellX, cellY);
+                    }
+                }
+                nextAlive = InRange(current.Get(x, y) ? m_rule.survivalRange : m_rule.birthRange, count);
+            } else {
+                // the halo makes the cells just outside of the board readable
+                std::uint32_t neighbourhood = 0;
+                for (int dy = -1; dy <= 1; dy++) {
+                    for (int dx = -1; dx <= 1; dx++) {
+                        neighbourhood |= static_cast<std::uint32_t>(current.Get(x + dx, y + dy)) << (3 * (dy + 1) + dx + 1);
+                    }
+                }
+                nextAlive = NextState(m_rule, neighbourhood);
+            }
+            next.SetState(x, y, NextCellState(m_rule, current.GetState(x, y), nextAlive));
+        }
+    }
+
+    next.RefreshHalo();
+}
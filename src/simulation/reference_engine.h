@@ -0,0 +1,16 @@
+#ifndef GAME_OF_LIFE_REFERENCE_ENGINE_H
+#define GAME_OF_LIFE_REFERENCE_ENGINE_H
+
+#include "engine.h"
+
+// Counts the neighbours of every cell one by one. Slow and obviously correct, the baseline
+// every other engine is measured and checked against.
+class ReferenceEngine : public Engine {
+public:
+    explicit ReferenceEngine(const Rule& rule);
+
+    const char* GetName() const override;
+    void Step(const Board& current, Board& next) override;
+};
+
+#endif //GAME_OF_LIFE_REFERENCE_ENGINE_H
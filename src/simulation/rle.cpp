@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+#include "rle.h"
+
+namespace {
+
+// value of "key = value" in the header line, empty when missing
+std::string headerValue(const std::string& header, const std::string& key) {
+    std::istringstream stream(header);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        size_t equals = item.find('=');
+        if (equals == std::string::npos) {
+            continue;
+        }
+
+        std::string name = item.substr(0, equals);
+        name.erase(0, name.find_first_not_of(" \t"));
+        name.erase(name.find_last_not_of(" \t") + 1);
+        if (name == key) {
+            std::string value = item.substr(equals + 1);
+            value.erase(0, value.find_first_not_of(" \t"));
+            value.erase(value.find_last_not_of(" \t\r") + 1);
+            return value;
+        }
+    }
+    return "";
+}
+
+// Golly's cell states: '.' is dead, 'A' to 'X' states 1 to 24 and the prefixes 'p' to 'y' add 24
+// each, "pA" is state 25
+std::string stateTag(int state) {
+    if (state == 0) {
+        return ".";
+    }
+    std::string tag;
+    if (state > 24) {
+        tag += static_cast<char>('p' + (state - 25) / 24);
+    }
+    tag += static_cast<char>('A' + (state - 1) % 24);
+    return tag;
+}
+
+}
+
+bool ParseRle(const std::string& text, Pattern& pattern) {
+    Pattern result;
+    std::istringstream stream(text);
+    std::string line;
+    std::string body;
+    bool header = false;
+
+    while (std::getline(stream, line)) {
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#') {
+            continue;
+        }
+        if (!header && line[start] == 'x') {
+            result.width = std::atoi(headerValue(line, "x").c_str());
+            result.height = std::atoi(headerValue(line, "y").c_str());
+            result.rule = headerValue(line, "rule");
+            header = true;
+            continue;
+        }
+        body += line.substr(start);
+    }
+
+    int x = 0;
+    int y = 0;
+    int count = 0;
+    bool finished = false;
+    for (size_t i = 0; i < body.size(); i++) {
+        char character = body[i];
+        if (std::isdigit(static_cast<unsigned char>(character))) {
+            count = count * 10 + (character - '0');
+            continue;
+        }
+
+        int run = count == 0 ? 1 : count;
+        count = 0;
+        if (character == '!') {
+            finished = true;
+            break;
+        } else if (character == '$') {
+            y += run;
+            x = 0;
+        } else if (character == 'b' || character == '.') {
+            x += run;
+        } else if (std::isalpha(static_cast<unsigned char>(character))) {
+            // multi-state letters, anything else lower case is a live cell of a two-state pattern
+            int state = 1;
+            if (character >= 'p' && character <= 'y' && i + 1 < body.size() && body[i + 1] >= 'A'
+                && body[i + 1] <= 'X') {
+                state = (character - 'p' + 1) * 24 + (body[++i] - 'A' + 1);
+            } else if (character >= 'A' && character <= 'X') {
+                state = character - 'A' + 1;
+            }
+            for (int cell = 0; cell < run; cell++) {
+                result.cells.emplace_back(x++, y);
+                result.states.push_back(state);
+            }
+        } else if (!std::isspace(static_cast<unsigned char>(character))) {
+            std::cout << "ERROR::RLE: Unexpected character '" << character << "'" << std::endl;
+            return false;
+        }
+    }
+
+    if (!finished) {
+        std::cout << "ERROR::RLE: Missing '!' at the end of the pattern" << std::endl;
+        return false;
+    }
+
+    // trust the cells over a missing or wrong header
+    for (const auto& cell : result.cells) {
+        result.width = std::max(result.width, cell.first + 1);
+        result.height = std::max(result.height, cell.second + 1);
+    }
+
+    pattern = std::move(result);
+    return true;
+}
+
+std::string WriteRle(const Board& board, const std::string& rule) {
+    std::ostringstream rle;
+    rle << "x = " << board.GetWidth() << ", y = " << board.GetHeight();
+    if (!rule.empty()) {
+        rle << ", rule = " << rule;
+    }
+    rle << "\n";
+
+    std::string body;
+    auto appendRun = [&body](int run, const std::string& tag) {
+        if (run > 1) {
+            body += std::to_string(run);
+        }
+        if (run > 0) {
+            body += tag;
+        }
+    };
+    // two-state boards keep the classic b and o
+    bool multiState = board.GetPlaneCount() > 1;
+    auto tag = [multiState](int state) {
+        if (!multiState) {
+            return std::string(state != 0 ? "o" : "b");
+        }
+        return stateTag(state);
+    };
+
+    int pendingRows = 0;
+    for (int y = 0; y < board.GetHeight(); y++) {
+        int lastAlive = -1;
+        for (int x = 0; x < board.GetWidth(); x++) {
+            if (board.GetState(x, y) != 0) {
+                lastAlive = x;
+            }
+        }
+        if (lastAlive < 0) {
+            pendingRows++;
+            continue;
+        }
+
+        // the row breaks since the previous live row, leading empty rows keep the pattern in place
+        appendRun(body.empty() ? pendingRows : pendingRows + 1, "$");
+        pendingRows = 0;
+
+        // dead cells after the last live one are implied by the end of the row
+        int run = 0;
+        int state = board.GetState(0, y);
+        for (int x = 0; x <= lastAlive; x++) {
+            int cell = board.GetState(x, y);
+            if (cell != state) {
+                appendRun(run, tag(state));
+                state = cell;
+                run = 0;
+            }
+            run++;
+        }
+        appendRun(run, tag(state));
+    }
+    body += '!';
+
+    // lines of at most 70 characters as Golly writes them
+    for (size_t start = 0; start < body.size(); start += 70) {
+        rle << body.substr(start, 70) << "\n";
+    }
+    return rle.str();
+}
+
+void PlacePattern(const Pattern& pattern, Board& board, int x, int y) {
+    int maxState = (1 << board.GetPlaneCount()) - 1;
+    for (size_t i = 0; i < pattern.cells.size(); i++) {
+        int cellX = x + pattern.cells[i].first;
+        int cellY = y + pattern.cells[i].second;
+        if (cellX >= 0 && cellX < board.GetWidth() && cellY >= 0 && cellY < board.GetHeight()) {
+            board.SetState(cellX, cellY, std::min(pattern.states[i], maxState));
+        }
+    }
+}
+
+void PlacePatternCentered(const Pattern& pattern, Board& board) {
+    PlacePattern(pattern, board, (board.GetWidth() - pattern.width) / 2, (board.GetHeight() - pattern.height) / 2);
+}
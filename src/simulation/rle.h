@@ -0,0 +1,34 @@
+#ifndef GAME_OF_LIFE_RLE_H
+#define GAME_OF_LIFE_RLE_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "board.h"
+
+// Live cells of a pattern relative to its top left corner.
+struct Pattern {
+    int width = 0;
+    int height = 0;
+    std::vector<std::pair<int, int>> cells;
+    // state of every cell, 1 unless the pattern is multi-state
+    std::vector<int> states;
+    // rule from the header, empty when the pattern does not name one
+    std::string rule;
+};
+
+// run length encoded pattern as used by Golly and the LifeWiki, including the multi-state
+// letters of Generations patterns
+bool ParseRle(const std::string& text, Pattern& pattern);
+
+// live cells of the board with an x/y header, rule is left out of the header when empty;
+// multi-state boards are written with a letter per state
+std::string WriteRle(const Board& board, const std::string& rule = "");
+
+// cells that fall outside of the board are dropped, states beyond the planes of the board are
+// clamped
+void PlacePattern(const Pattern& pattern, Board& board, int x, int y);
+void PlacePatternCentered(const Pattern& pattern, Board& board);
+
+#endif //GAME_OF_LIFE_RLE_H
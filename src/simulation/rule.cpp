@@ -0,0 +1,368 @@
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <utility>
+
+#include "rule.h"
+
+namespace {
+
+constexpr std::uint32_t centreBit = 1 << 4;
+constexpr std::uint32_t neighbourBits = 0x1FF & ~centreBit;
+
+// Hensel's letters for the neighbourhoods with 0 to 4 live neighbours and one neighbourhood of
+// each letter; 5 to 8 neighbours use the letters of 8 - n for the complementary neighbourhoods
+const char* const henselLetters[5] = {"", "ce", "ceaikn", "ceaiknjqry", "ceaiknjqrytwz"};
+const std::uint16_t henselNeighbourhoods[5][13] = {
+        {},
+        {1, 2},
+        {5, 10, 3, 40, 33, 68},
+        {69, 42, 11, 7, 98, 13, 14, 70, 41, 97},
+        {325, 170, 15, 45, 99, 71, 106, 102, 43, 101, 105, 78, 108},
+};
+
+int countNeighbours(std::uint32_t neighbourhood) {
+    int count = 0;
+    for (int bit = 0; bit < 9; bit++) {
+        count += ((neighbourhood & neighbourBits) >> bit) & 1;
+    }
+    return count;
+}
+
+// the neighbourhood turned a quarter clockwise, or mirrored west to east
+std::uint32_t rotate(std::uint32_t neighbourhood) {
+    std::uint32_t result = 0;
+    for (int row = 0; row < 3; row++) {
+        for (int column = 0; column < 3; column++) {
+            result |= ((neighbourhood >> (3 * row + column)) & 1) << (3 * column + 2 - row);
+        }
+    }
+    return result;
+}
+
+std::uint32_t mirror(std::uint32_t neighbourhood) {
+    std::uint32_t result = 0;
+    for (int row = 0; row < 3; row++) {
+        for (int column = 0; column < 3; column++) {
+            result |= ((neighbourhood >> (3 * row + column)) & 1) << (3 * row + 2 - column);
+        }
+    }
+    return result;
+}
+
+void setNextState(Rule& rule, std::uint32_t neighbourhood, bool alive) {
+    std::uint64_t bit = std::uint64_t(1) << (neighbourhood % 64);
+    std::uint64_t& word = rule.table[neighbourhood / 64];
+    word = alive ? word | bit : word & ~bit;
+}
+
+// the neighbourhood with all its rotations and reflections
+void setSymmetricNextState(Rule& rule, std::uint32_t neighbourhood, bool alive) {
+    for (int reflection = 0; reflection < 2; reflection++) {
+        for (int turn = 0; turn < 4; turn++) {
+            setNextState(rule, neighbourhood, alive);
+            neighbourhood = rotate(neighbourhood);
+        }
+        neighbourhood = mirror(neighbourhood);
+    }
+}
+
+// neighbourhood of the letter with count live neighbours, false when the count has no such letter
+bool letterNeighbourhood(int count, char letter, std::uint32_t& neighbourhood) {
+    int base = count <= 4 ? count : 8 - count;
+    const char* found = std::strchr(henselLetters[base], letter);
+    if (letter == '\0' || found == nullptr) {
+        return false;
+    }
+
+    neighbourhood = henselNeighbourhoods[base][found - henselLetters[base]];
+    if (count > 4) {
+        neighbourhood = ~neighbourhood & neighbourBits;
+    }
+    return true;
+}
+
+// counts with optional letters, "2-a" or "34q", into the table entries of dead or live cells
+bool parseHalf(const std::string& text, bool alive, Rule& rule) {
+    std::uint32_t state = alive ? centreBit : 0;
+    size_t i = 0;
+    while (i < text.size()) {
+        char digit = text[i++];
+        if (digit < '0' || digit > '8') {
+            return false;
+        }
+        int count = digit - '0';
+
+        bool excluding = i < text.size() && text[i] == '-';
+        if (excluding) {
+            i++;
+        }
+        std::string letters;
+        while (i < text.size() && std::isalpha(static_cast<unsigned char>(text[i]))) {
+            letters += text[i++];
+        }
+        if (excluding && letters.empty()) {
+            return false;
+        }
+
+        if (letters.empty() || excluding) {
+            for (std::uint32_t neighbourhood = 0; neighbourhood < 512; neighbourhood++) {
+                if (!(neighbourhood & centreBit) && countNeighbours(neighbourhood) == count) {
+                    setNextState(rule, neighbourhood | state, true);
+                }
+            }
+        }
+        for (char letter : letters) {
+            std::uint32_t neighbourhood;
+            if (!letterNeighbourhood(count, letter, neighbourhood)) {
+                return false;
+            }
+            setSymmetricNextState(rule, neighbourhood | state, !excluding);
+        }
+    }
+    return true;
+}
+
+// the outer-totalistic form of a table rule, when it has one
+Rule simplify(const Rule& rule) {
+    Rule totalistic{0, 0};
+    for (std::uint32_t neighbourhood = 0; neighbourhood < 512; neighbourhood++) {
+        if (NextState(rule, neighbourhood)) {
+            std::uint16_t& counts = neighbourhood & centreBit ? totalistic.survival : totalistic.birth;
+            counts |= 1 << countNeighbours(neighbourhood);
+        }
+    }
+
+    for (std::uint32_t neighbourhood = 0; neighbourhood < 512; neighbourhood++) {
+        if (NextState(totalistic, neighbourhood) != NextState(rule, neighbourhood)) {
+            return rule;
+        }
+    }
+    return totalistic;
+}
+
+// "34..58", a single count or nothing for an empty range
+bool parseRange(const std::string& text, RuleRange& range) {
+    if (text.empty()) {
+        range = RuleRange{1, 0};
+        return true;
+    }
+
+    size_t dots = text.find("..");
+    std::string first = text.substr(0, dots);
+    std::string last = dots == std::string::npos ? first : text.substr(dots + 2);
+    for (const std::string* count : {&first, &last}) {
+        if (count->empty() || count->size() > 5 || count->find_first_not_of("0123456789") != std::string::npos) {
+            return false;
+        }
+    }
+    int firstCount = std::stoi(first);
+    int lastCount = std::stoi(last);
+    if (firstCount > 0xFFFF || lastCount > 0xFFFF) {
+        return false;
+    }
+    range = firstCount <= lastCount
+            ? RuleRange{static_cast<std::uint16_t>(firstCount), static_cast<std::uint16_t>(lastCount)}
+            : RuleRange{1, 0};
+    return true;
+}
+
+// Evans' "r5,c0,m1,s34..58,b34..45,nm", the radius, state count, whether the cell counts
+// itself, the survival and birth ranges and the neighbourhood
+bool parseLargerThanLife(const std::string& text, Rule& rule) {
+    Rule parsed{0, 0};
+    std::string neighbourhood = "m";
+    bool hasRadius = false;
+    bool hasSurvival = false;
+    bool hasBirth = false;
+
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t comma = std::min(text.find(',', start), text.size());
+        std::string part = text.substr(start, comma - start);
+        start = comma + 1;
+        if (part.empty()) {
+            return false;
+        }
+
+        std::string value = part.substr(1);
+        bool isNumber = !value.empty() && value.size() <= 3
+                        && value.find_first_not_of("0123456789") == std::string::npos;
+        switch (part[0]) {
+            case 'r':
+                if (!isNumber) {
+                    return false;
+                }
+                parsed.radius = std::stoi(value);
+                hasRadius = true;
+                break;
+            case 'c':
+                if (!isNumber) {
+                    return false;
+                }
+                // C0 and C2 are both two-state
+                parsed.states = std::max(2, std::stoi(value));
+                break;
+            case 'm':
+                if (value != "0" && value != "1") {
+                    return false;
+                }
+                parsed.countsCentre = value == "1";
+                break;
+            case 's':
+                hasSurvival = parseRange(value, parsed.survivalRange);
+                if (!hasSurvival) {
+                    return false;
+                }
+                break;
+            case 'b':
+                hasBirth = parseRange(value, parsed.birthRange);
+                if (!hasBirth) {
+                    return false;
+                }
+                break;
+            case 'n':
+                neighbourhood = value;
+                break;
+            default:
+                return false;
+        }
+    }
+
+    // only the Moore neighbourhood, the box around the cell
+    if (!hasRadius || !hasSurvival || !hasBirth || neighbourhood != "m"
+        || parsed.radius < 1 || parsed.radius > MaxRuleRadius || parsed.states > MaxRuleStates) {
+        return false;
+    }
+
+    if (parsed.radius == 1) {
+        // the ranges become the counts of the 8 neighbours of outer-totalistic rules
+        Rule totalistic{0, 0};
+        totalistic.states = parsed.states;
+        for (int count = 0; count <= 8; count++) {
+            if (InRange(parsed.birthRange, count)) {
+                totalistic.birth |= static_cast<std::uint16_t>(1 << count);
+            }
+            if (InRange(parsed.survivalRange, parsed.countsCentre ? count + 1 : count)) {
+                totalistic.survival |= static_cast<std::uint16_t>(1 << count);
+            }
+        }
+        parsed = totalistic;
+    }
+
+    rule = parsed;
+    return true;
+}
+
+std::string formatRange(const RuleRange& range) {
+    if (range.first > range.last) {
+        return "";
+    }
+    return std::to_string(range.first) + ".." + std::to_string(range.last);
+}
+
+// the counts of dead or live cells, with the letters present, or the absent ones after a minus
+// when that is shorter
+std::string formatHalf(const Rule& rule, bool alive) {
+    std::uint32_t state = alive ? centreBit : 0;
+    std::string text;
+    for (int count = 0; count <= 8; count++) {
+        std::string present;
+        std::string absent;
+        int base = count <= 4 ? count : 8 - count;
+        for (const char* letter = henselLetters[base]; *letter != '\0'; letter++) {
+            std::uint32_t neighbourhood = 0;
+            letterNeighbourhood(count, *letter, neighbourhood);
+            (NextState(rule, neighbourhood | state) ? present : absent) += *letter;
+        }
+
+        char digit = static_cast<char>('0' + count);
+        if (base == 0) {
+            // a single neighbourhood and no letters
+            if (NextState(rule, (count == 0 ? 0 : neighbourBits) | state)) {
+                text += digit;
+            }
+        } else if (absent.empty()) {
+            text += digit;
+        } else if (present.size() > absent.size()) {
+            text += digit + ("-" + absent);
+        } else if (!present.empty()) {
+            text += digit + present;
+        }
+    }
+    return text;
+}
+
+}
+
+bool ParseRule(const std::string& text, Rule& rule) {
+    std::string lower;
+    for (char c : text) {
+        if (!std::isspace(static_cast<unsigned char>(c))) {
+            lower += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+    }
+
+    if (lower.size() > 1 && lower[0] == 'r' && std::isdigit(static_cast<unsigned char>(lower[1]))) {
+        return parseLargerThanLife(lower, rule);
+    }
+
+    size_t slash = lower.find('/');
+    if (slash == std::string::npos) {
+        return false;
+    }
+    std::string first = lower.substr(0, slash);
+    std::string second = lower.substr(slash + 1);
+
+    // the number of states of Generations rules, "c3" or just "3"
+    int states = 2;
+    size_t statesSlash = second.find('/');
+    if (statesSlash != std::string::npos) {
+        std::string count = second.substr(statesSlash + 1);
+        second = second.substr(0, statesSlash);
+        if (!count.empty() && count[0] == 'c') {
+            count = count.substr(1);
+        }
+        if (count.empty() || count.size() > 3 || count.find_first_not_of("0123456789") != std::string::npos) {
+            return false;
+        }
+        states = std::stoi(count);
+        if (states < 2 || states > MaxRuleStates) {
+            return false;
+        }
+    }
+
+    if (!first.empty() && !second.empty() && first[0] == 's' && second[0] == 'b') {
+        std::swap(first, second);
+    }
+
+    Rule parsed{0, 0};
+    parsed.nonTotalistic = true;
+    if (!first.empty() && first[0] == 'b') {
+        if (second.empty() || second[0] != 's' ||
+            !parseHalf(first.substr(1), false, parsed) || !parseHalf(second.substr(1), true, parsed)) {
+            return false;
+        }
+    } else if (!parseHalf(first, true, parsed) || !parseHalf(second, false, parsed)) {
+        // neither B/S nor survival/birth without letters
+        return false;
+    }
+
+    rule = simplify(parsed);
+    rule.states = states;
+    return true;
+}
+
+std::string FormatRule(const Rule& rule) {
+    if (rule.radius > 1) {
+        return "R" + std::to_string(rule.radius) + ",C" + std::to_string(rule.states > 2 ? rule.states : 0)
+               + ",M" + (rule.countsCentre ? "1" : "0") + ",S" + formatRange(rule.survivalRange)
+               + ",B" + formatRange(rule.birthRange) + ",NM";
+    }
+
+    std::string text = "B" + formatHalf(rule, false) + "/S" + formatHalf(rule, true);
+    if (rule.states > 2) {
+        text += "/C" + std::to_string(rule.states);
+    }
+    return text;
+}
@@ -0,0 +1,144 @@
+#ifndef GAME_OF_LIFE_RULE_H
+#define GAME_OF_LIFE_RULE_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Inclusive range of neighbour counts, empty when first > last.
+struct RuleRange {
+    std::uint16_t first;
+    std::uint16_t last;
+};
+
+// Life-like rule on the 3x3 neighbourhood, or a Larger-than-Life rule on a wider box.
+//
+// Outer-totalistic rules set birth and survival: bit n of birth is set when a dead cell with n
+// live neighbours comes alive, bit n of survival when a live cell with n live neighbours stays
+// alive. Non-totalistic rules set table instead, the next state of every neighbourhood.
+//
+// Generations rules have more than two states: a live cell that does not survive passes through
+// states 2 to states - 1 before it is dead again, dying cells neither count as neighbours nor
+// can be born into.
+//
+// Larger-than-Life rules have a radius above 1 and count the live cells of the
+// (2 * radius + 1)^2 box around a cell, the cell itself only when countsCentre is set. A dead
+// cell is born when the count is in birthRange, a live one survives when it is in survivalRange.
+// Rules of radius 1 always use birth and survival.
+struct Rule {
+    std::uint16_t birth;
+    std::uint16_t survival;
+    bool nonTotalistic = false;
+    // bit i of the 512 is the next state of a cell whose neighbourhood is i, see NextState
+    std::array<std::uint64_t, 8> table = {};
+    int states = 2;
+    int radius = 1;
+    bool countsCentre = false;
+    RuleRange birthRange = {1, 0};
+    RuleRange survivalRange = {1, 0};
+};
+
+constexpr int MaxRuleStates = 256;
+// the counts of the widest box still fit 16 bits
+constexpr int MaxRuleRadius = 64;
+
+constexpr bool operator==(const Rule& left, const Rule& right) {
+    if (left.nonTotalistic != right.nonTotalistic || left.states != right.states || left.radius != right.radius) {
+        return false;
+    }
+    if (left.radius > 1) {
+        return left.countsCentre == right.countsCentre
+               && left.birthRange.first == right.birthRange.first && left.birthRange.last == right.birthRange.last
+               && left.survivalRange.first == right.survivalRange.first
+               && left.survivalRange.last == right.survivalRange.last;
+    }
+    if (!left.nonTotalistic) {
+        return left.birth == right.birth && left.survival == right.survival;
+    }
+    for (size_t i = 0; i < left.table.size(); i++) {
+        if (left.table[i] != right.table[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr bool operator!=(const Rule& left, const Rule& right) {
+    return !(left == right);
+}
+
+// B3/S23
+constexpr Rule ConwayRule{1 << 3, 1 << 2 | 1 << 3};
+// B36/S23
+constexpr Rule HighLifeRule{1 << 3 | 1 << 6, 1 << 2 | 1 << 3};
+// B2/S
+constexpr Rule SeedsRule{1 << 2, 0};
+// B3678/S34678
+constexpr Rule DayAndNightRule{1 << 3 | 1 << 6 | 1 << 7 | 1 << 8, 1 << 3 | 1 << 4 | 1 << 6 | 1 << 7 | 1 << 8};
+// B2/S/C3
+constexpr Rule BriansBrainRule{1 << 2, 0, false, {}, 3};
+// B2/S345/C4
+constexpr Rule StarWarsRule{1 << 2, 1 << 3 | 1 << 4 | 1 << 5, false, {}, 4};
+// R5,C0,M1,S34..58,B34..45,NM
+constexpr Rule BoscosRule{0, 0, false, {}, 2, 5, true, {34, 45}, {34, 58}};
+
+// planes of a board holding the states of the rule, ceil(log2(states))
+constexpr int GetStatePlaneCount(const Rule& rule) {
+    int planes = 1;
+    while ((1 << planes) < rule.states) {
+        planes++;
+    }
+    return planes;
+}
+
+// the rule between live and dead cells only, what decides births and survival under Generations
+constexpr Rule GetTwoStateRule(const Rule& rule) {
+    Rule twoState = rule;
+    twoState.states = 2;
+    return twoState;
+}
+
+// next state of a cell whose 3x3 neighbourhood is the 9 bit index, bit 3 * row + column with
+// the rows from above to below, the columns from west to east, so the cell itself is bit 4
+constexpr bool NextState(const Rule& rule, std::uint32_t neighbourhood) {
+    if (rule.nonTotalistic) {
+        return (rule.table[neighbourhood / 64] >> (neighbourhood % 64)) & 1;
+    }
+
+    int count = 0;
+    for (int bit = 0; bit < 9; bit++) {
+        count += bit != 4 ? (neighbourhood >> bit) & 1 : 0;
+    }
+    bool alive = (neighbourhood >> 4) & 1;
+    return ((alive ? rule.survival : rule.birth) >> count) & 1;
+}
+
+constexpr bool InRange(const RuleRange& range, int count) {
+    return count >= range.first && count <= range.last;
+}
+
+// next state of a cell in state, nextAlive is the next state under the two-state rule with the
+// dying cells taken as dead, from NextState or the ranges of Larger-than-Life rules
+constexpr int NextCellState(const Rule& rule, int state, bool nextAlive) {
+    if (state >= 2) {
+        return (state + 1) % rule.states;
+    }
+    if (nextAlive) {
+        return 1;
+    }
+    return state == 1 && rule.states > 2 ? 2 : 0;
+}
+
+// "B3/S23" in any case and order of the two parts, or the older "23/3" survival/birth notation.
+// Counts may be followed by Hensel's letters for isotropic non-totalistic rules, "B2-a/S12" or
+// "B3/S2-i34q"; rules whose letters cover whole counts come out outer-totalistic. A third part
+// makes a Generations rule, "B2/S/C3" or "/2/3". Larger-than-Life rules use Evans' notation
+// with the Moore neighbourhood, "R5,C0,M1,S34..58,B34..45,NM"; at radius 1 they come out
+// outer-totalistic.
+bool ParseRule(const std::string& text, Rule& rule);
+
+// B/S notation, e.g. "B36/S23", with Hensel letters for non-totalistic rules and /C for
+// Generations rules, or Evans' notation for Larger-than-Life rules
+std::string FormatRule(const Rule& rule);
+
+#endif //GAME_OF_LIFE_RULE_H
@@ -0,0 +1,381 @@
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "rule_circuit.h"
+
+namespace {
+
+// bit i is the value of a function for the inputs whose bit k is input k, 2^9 entries
+using TruthTable = std::array<std::uint64_t, 8>;
+
+// Function with don't cares: care marks the inputs that matter. Counts above 8 never occur, and
+// outer-totalistic rules only use the first 32 entries.
+struct Function {
+    TruthTable table;
+    TruthTable care;
+};
+
+// truth tables of input k within a word, for the inputs below 6
+const std::uint64_t inputWords[6] = {
+        0xAAAAAAAAAAAAAAAAull, 0xCCCCCCCCCCCCCCCCull, 0xF0F0F0F0F0F0F0F0ull,
+        0xFF00FF00FF00FF00ull, 0xFFFF0000FFFF0000ull, 0xFFFFFFFF00000000ull,
+};
+
+TruthTable constantTable(std::uint64_t word) {
+    TruthTable table;
+    table.fill(word);
+    return table;
+}
+
+TruthTable inputTable(int input) {
+    TruthTable table{};
+    for (size_t w = 0; w < table.size(); w++) {
+        table[w] = input < 6 ? inputWords[input] : (((w >> (input - 6)) & 1) ? ~std::uint64_t(0) : 0);
+    }
+    return table;
+}
+
+TruthTable apply(RuleCircuit::Op op, const TruthTable& a, const TruthTable& b) {
+    TruthTable result{};
+    for (size_t w = 0; w < result.size(); w++) {
+        switch (op) {
+            case RuleCircuit::Op::And:
+                result[w] = a[w] & b[w];
+                break;
+            case RuleCircuit::Op::Or:
+                result[w] = a[w] | b[w];
+                break;
+            case RuleCircuit::Op::Xor:
+                result[w] = a[w] ^ b[w];
+                break;
+            case RuleCircuit::Op::AndNot:
+                result[w] = a[w] & ~b[w];
+                break;
+            case RuleCircuit::Op::OrNot:
+                result[w] = a[w] | ~b[w];
+                break;
+        }
+    }
+    return result;
+}
+
+// the table with the input fixed to value, as a table that no longer depends on it
+TruthTable cofactor(const TruthTable& table, int input, int value) {
+    TruthTable result{};
+    for (size_t w = 0; w < result.size(); w++) {
+        if (input < 6) {
+            int shift = 1 << input;
+            std::uint64_t kept = table[w] & (value ? inputWords[input] : ~inputWords[input]);
+            result[w] = value ? kept | (kept >> shift) : kept | (kept << shift);
+        } else {
+            size_t stride = size_t(1) << (input - 6);
+            result[w] = table[value ? w | stride : w & ~stride];
+        }
+    }
+    return result;
+}
+
+Function cofactor(const Function& f, int input, int value) {
+    return Function{cofactor(f.table, input, value), cofactor(f.care, input, value)};
+}
+
+bool matches(const Function& f, const TruthTable& table) {
+    for (size_t w = 0; w < table.size(); w++) {
+        if ((f.table[w] ^ table[w]) & f.care[w]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool compatible(const Function& a, const Function& b) {
+    for (size_t w = 0; w < a.table.size(); w++) {
+        if ((a.table[w] ^ b.table[w]) & a.care[w] & b.care[w]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// one function agreeing with both where they care
+Function merge(const Function& a, const Function& b) {
+    Function result{};
+    for (size_t w = 0; w < a.table.size(); w++) {
+        result.table[w] = (a.table[w] & a.care[w]) | (b.table[w] & b.care[w]);
+        result.care[w] = a.care[w] | b.care[w];
+    }
+    return result;
+}
+
+Function complement(const Function& f) {
+    Function result = f;
+    for (std::uint64_t& word : result.table) {
+        word = ~word;
+    }
+    return result;
+}
+
+using Key = std::array<std::uint64_t, 16>;
+
+struct KeyHash {
+    size_t operator()(const Key& key) const {
+        std::uint64_t hash = 0xCBF29CE484222325ull;
+        for (std::uint64_t word : key) {
+            hash = (hash ^ word) * 0x100000001B3ull;
+            hash ^= hash >> 29;
+        }
+        return static_cast<size_t>(hash);
+    }
+};
+
+Key key(const Function& f) {
+    Key key{};
+    for (size_t w = 0; w < f.table.size(); w++) {
+        key[w] = f.table[w] & f.care[w];
+        key[w + f.table.size()] = f.care[w];
+    }
+    return key;
+}
+
+// Shannon decomposition on one input, picking for every subfunction the input and the form
+// with the fewest instructions; the cofactors keep the don't cares, which is what lets B3/S23
+// come out as (s0 | alive) & ~s2 & s1
+class Synthesizer {
+public:
+    Synthesizer(int inputCount, std::vector<RuleCircuit::Instruction>& instructions)
+            : m_inputCount(inputCount), m_instructions(instructions) {
+        for (int input = 0; input < inputCount; input++) {
+            m_tables.push_back(inputTable(input));
+        }
+        m_tables.push_back(constantTable(0));
+        m_tables.push_back(constantTable(~std::uint64_t(0)));
+    }
+
+    // register holding f
+    int Emit(const Function& f) {
+        for (size_t r = 0; r < m_tables.size(); r++) {
+            if (matches(f, m_tables[r])) {
+                return static_cast<int>(r);
+            }
+        }
+
+        Choice choice = choose(f);
+        Function f0 = cofactor(f, choice.input, 0);
+        Function f1 = cofactor(f, choice.input, 1);
+        int x = choice.input;
+        switch (choice.form) {
+            case Form::Independent:
+                return Emit(merge(f0, f1));
+            case Form::And:
+                return add(RuleCircuit::Op::And, x, Emit(f1));
+            case Form::AndNot:
+                return add(RuleCircuit::Op::AndNot, Emit(f0), x);
+            case Form::OrNot:
+                return add(RuleCircuit::Op::OrNot, Emit(f1), x);
+            case Form::Or:
+                return add(RuleCircuit::Op::Or, x, Emit(f0));
+            case Form::Xor:
+                return add(RuleCircuit::Op::Xor, x, Emit(merge(f0, complement(f1))));
+            case Form::Mux:
+            default: {
+                // f0 ^ (x & (f0 ^ f1))
+                int low = Emit(f0);
+                int high = Emit(f1);
+                int difference = add(RuleCircuit::Op::And, x, add(RuleCircuit::Op::Xor, low, high));
+                return add(RuleCircuit::Op::Xor, low, difference);
+            }
+        }
+    }
+
+private:
+    enum class Form {
+        // the input does not matter, f is its merged cofactors
+        Independent,
+        // x & f1
+        And,
+        // f0 & ~x
+        AndNot,
+        // f1 | ~x
+        OrNot,
+        // x | f0
+        Or,
+        // x ^ f0
+        Xor,
+        Mux,
+    };
+
+    struct Choice {
+        int cost;
+        int input;
+        Form form;
+    };
+
+    int cost(const Function& f) {
+        for (const TruthTable& table : m_tables) {
+            if (matches(f, table)) {
+                return 0;
+            }
+        }
+        return choose(f).cost;
+    }
+
+    Choice choose(const Function& f) {
+        Key fKey = key(f);
+        auto found = m_choices.find(fKey);
+        if (found != m_choices.end()) {
+            return found->second;
+        }
+
+        Choice best{1 << 20, 0, Form::Mux};
+        auto consider = [&best](int cost, int input, Form form) {
+            if (cost < best.cost) {
+                best = Choice{cost, input, form};
+            }
+        };
+
+        const TruthTable zeros = constantTable(0);
+        const TruthTable ones = constantTable(~std::uint64_t(0));
+        for (int x = 0; x < m_inputCount; x++) {
+            Function f0 = cofactor(f, x, 0);
+            Function f1 = cofactor(f, x, 1);
+            if (compatible(f0, f1)) {
+                Function merged = merge(f0, f1);
+                if (key(merged) != fKey) {
+                    consider(cost(merged), x, Form::Independent);
+                }
+                continue;
+            }
+
+            if (matches(f0, zeros)) {
+                consider(1 + cost(f1), x, Form::And);
+            }
+            if (matches(f1, zeros)) {
+                consider(1 + cost(f0), x, Form::AndNot);
+            }
+            if (matches(f0, ones)) {
+                consider(1 + cost(f1), x, Form::OrNot);
+            }
+            if (matches(f1, ones)) {
+                consider(1 + cost(f0), x, Form::Or);
+            }
+            if (compatible(f0, complement(f1))) {
+                consider(1 + cost(merge(f0, complement(f1))), x, Form::Xor);
+            }
+            consider(3 + cost(f0) + cost(f1), x, Form::Mux);
+        }
+
+        m_choices[fKey] = best;
+        return best;
+    }
+
+    int add(RuleCircuit::Op op, int a, int b) {
+        m_instructions.push_back(RuleCircuit::Instruction{op, static_cast<std::uint16_t>(a),
+                                                          static_cast<std::uint16_t>(b)});
+        m_tables.push_back(apply(op, m_tables[a], m_tables[b]));
+        return static_cast<int>(m_tables.size()) - 1;
+    }
+
+    int m_inputCount;
+    std::vector<RuleCircuit::Instruction>& m_instructions;
+    // truth table of every register so far, reused whenever a subfunction matches one
+    std::vector<TruthTable> m_tables;
+    std::unordered_map<Key, Choice, KeyHash> m_choices;
+};
+
+}
+
+RuleCircuit::RuleCircuit(const Rule& rule) : m_rule(rule) {
+    Function next{};
+    if (rule.nonTotalistic) {
+        // inputs are the neighbourhood bits themselves
+        m_inputCount = NeighbourhoodInputCount;
+        next.table = rule.table;
+        next.care = constantTable(~std::uint64_t(0));
+    } else {
+        // inputs are s0..s3 and the cell, counts above 8 never occur
+        m_inputCount = CountInputCount;
+        for (int i = 0; i < 32; i++) {
+            int count = i & 0xF;
+            bool alive = (i >> 4) & 1;
+            if (count <= 8) {
+                next.care[0] |= std::uint64_t(1) << i;
+                next.table[0] |= static_cast<std::uint64_t>(((alive ? rule.survival : rule.birth) >> count) & 1) << i;
+            }
+        }
+    }
+
+    Synthesizer synthesizer(m_inputCount, m_instructions);
+    m_result = synthesizer.Emit(next);
+}
+
+const Rule& RuleCircuit::GetRule() const {
+    return m_rule;
+}
+
+int RuleCircuit::GetInputCount() const {
+    return m_inputCount;
+}
+
+const std::vector<RuleCircuit::Instruction>& RuleCircuit::GetInstructions() const {
+    return m_instructions;
+}
+
+int RuleCircuit::GetRegisterCount() const {
+    return m_inputCount + 2 + static_cast<int>(m_instructions.size());
+}
+
+const std::uint64_t* RuleCircuit::Evaluate(std::uint64_t* registers) const {
+    std::uint64_t* constants = registers + m_inputCount * Lanes;
+    std::fill(constants, constants + Lanes, 0);
+    std::fill(constants + Lanes, constants + 2 * Lanes, ~std::uint64_t(0));
+
+    std::uint64_t* out = constants + 2 * Lanes;
+    for (const Instruction& instruction : m_instructions) {
+        const std::uint64_t* a = registers + instruction.a * Lanes;
+        const std::uint64_t* b = registers + instruction.b * Lanes;
+        switch (instruction.op) {
+            case Op::And:
+                for (int lane = 0; lane < Lanes; lane++) {
+                    out[lane] = a[lane] & b[lane];
+                }
+                break;
+            case Op::Or:
+                for (int lane = 0; lane < Lanes; lane++) {
+                    out[lane] = a[lane] | b[lane];
+                }
+                break;
+            case Op::Xor:
+                for (int lane = 0; lane < Lanes; lane++) {
+                    out[lane] = a[lane] ^ b[lane];
+                }
+                break;
+            case Op::AndNot:
+                for (int lane = 0; lane < Lanes; lane++) {
+                    out[lane] = a[lane] & ~b[lane];
+                }
+                break;
+            case Op::OrNot:
+                for (int lane = 0; lane < Lanes; lane++) {
+                    out[lane] = a[lane] | ~b[lane];
+                }
+                break;
+        }
+        out += Lanes;
+    }
+    return registers + m_result * Lanes;
+}
+
+std::shared_ptr<const RuleCircuit> CompileRuleCircuit(const Rule& rule) {
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::shared_ptr<const RuleCircuit>> circuits;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<const RuleCircuit>& circuit = circuits[FormatRule(rule)];
+    if (!circuit) {
+        circuit = std::make_shared<const RuleCircuit>(rule);
+    }
+    return circuit;
+}
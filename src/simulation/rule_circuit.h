@@ -0,0 +1,64 @@
+#ifndef GAME_OF_LIFE_RULE_CIRCUIT_H
+#define GAME_OF_LIFE_RULE_CIRCUIT_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "rule.h"
+
+// Straight-line boolean circuit computing the next state of bit-sliced cells under a rule,
+// synthesized at run time so that rules without a hand-written kernel still take a handful of
+// word operations per 64 cells.
+//
+// The inputs of outer-totalistic rules are the count bits s0..s3 and the cells themselves,
+// those of non-totalistic rules the nine bitplanes of the neighbourhood: input k holds bit k of
+// every cell's neighbourhood index (see NextState), no per-cell table lookup is left. The inputs
+// are followed by registers of all zeros and all ones, every instruction writes the next
+// register. The circuit is interpreted over Lanes words at once so the dispatch cost is shared
+// by 512 cells and the per instruction loops can be vectorized.
+class RuleCircuit {
+public:
+    static constexpr int Lanes = 8;
+    static constexpr int CountInputCount = 5;
+    static constexpr int NeighbourhoodInputCount = 9;
+
+    enum class Op : std::uint8_t {
+        And,
+        Or,
+        Xor,
+        // a & ~b
+        AndNot,
+        // a | ~b
+        OrNot,
+    };
+
+    struct Instruction {
+        Op op;
+        std::uint16_t a;
+        std::uint16_t b;
+    };
+
+    explicit RuleCircuit(const Rule& rule);
+
+    const Rule& GetRule() const;
+    // CountInputCount for outer-totalistic rules, NeighbourhoodInputCount for the others
+    int GetInputCount() const;
+    const std::vector<Instruction>& GetInstructions() const;
+    int GetRegisterCount() const;
+
+    // registers holds GetRegisterCount() * Lanes words with the inputs filled in, lane l of
+    // register r at r * Lanes + l; returns the lanes of the result register
+    const std::uint64_t* Evaluate(std::uint64_t* registers) const;
+
+private:
+    Rule m_rule;
+    int m_inputCount;
+    std::vector<Instruction> m_instructions;
+    int m_result;
+};
+
+// compiled circuits are shared between engines, keyed by the rule string
+std::shared_ptr<const RuleCircuit> CompileRuleCircuit(const Rule& rule);
+
+#endif //GAME_OF_LIFE_RULE_CIRCUIT_H
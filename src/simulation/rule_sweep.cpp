@@ -0,0 +1,171 @@
+#include <algorithm>
+
+#include "rule_sweep.h"
+#include "batch_engine.h"
+#include "bits.h"
+#include "../profiling/trace.h"
+
+namespace {
+
+const char* const outcomeNames[] = {"dies", "stabilizes", "explodes", "chaotic"};
+
+std::uint64_t splitMix64(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// sets the bits of the boards that differ between the batches and of the boards of current with
+// live cells, a pass over the words without looking at single boards
+void compareBoards(const BoardBatch& current, const BoardBatch& snapshot, std::vector<std::uint64_t>& differs,
+                   std::vector<std::uint64_t>& alive) {
+    int lanes = current.GetLaneWords();
+    int count = current.GetWidth() * lanes;
+    for (int w = 0; w < lanes; w++) {
+        // in locals, stores through the vectors could alias the rows
+        std::uint64_t differ = 0;
+        std::uint64_t live = 0;
+        for (int y = 0; y < current.GetHeight(); y++) {
+            const std::uint64_t* row = current.GetCell(0, y) + w;
+            const std::uint64_t* snapshotRow = snapshot.GetCell(0, y) + w;
+            for (int i = 0; i < count; i += lanes) {
+                differ |= row[i] ^ snapshotRow[i];
+                live |= row[i];
+            }
+        }
+        differs[w] = differ;
+        alive[w] = live;
+    }
+}
+
+}
+
+const char* GetSweepOutcomeName(SweepOutcome outcome) {
+    return outcomeNames[static_cast<int>(outcome)];
+}
+
+bool ParseSweepOutcome(const std::string& name, SweepOutcome& outcome) {
+    for (int i = 0; i < 4; i++) {
+        if (name == outcomeNames[i]) {
+            outcome = static_cast<SweepOutcome>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+RuleSweep::RuleSweep(const SweepOptions& options, int threadCount)
+        : m_options(options), m_soups(options.boardSize, options.boardSize, options.soupCount), m_pool(threadCount) {
+    std::uint64_t state = options.seed;
+    int offset = (options.boardSize - options.soupSize) / 2;
+    for (int soup = 0; soup < options.soupCount; soup++) {
+        Board cells(options.soupSize, options.soupSize);
+        cells.Randomize(splitMix64(state), options.density);
+        for (int y = 0; y < options.soupSize; y++) {
+            for (int x = 0; x < options.soupSize; x++) {
+                m_soups.Set(soup, x + offset, y + offset, cells.Get(x, y));
+            }
+        }
+    }
+    m_soups.RefreshHalo();
+}
+
+bool RuleSweep::Supports(const Rule& rule) {
+    return BatchEngine::Supports(rule);
+}
+
+const SweepOptions& RuleSweep::GetOptions() const {
+    return m_options;
+}
+
+int RuleSweep::GetThreadCount() const {
+    return m_pool.GetThreadCount();
+}
+
+std::vector<SweepResult> RuleSweep::Run(const std::vector<Rule>& rules) {
+    GOL_TRACE_SCOPE("RuleSweep::Run");
+    std::vector<SweepResult> results(rules.size());
+    m_pool.ParallelFor(static_cast<int>(rules.size()), [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            results[i] = RunRule(rules[i]);
+        }
+    });
+    return results;
+}
+
+SweepResult RuleSweep::RunRule(const Rule& rule) const {
+    SweepResult result{rule, SweepOutcome::Chaotic, 0, {}, 0};
+    BatchEngine engine(rule);
+    BoardBatch current = m_soups;
+    BoardBatch next = m_soups;
+    BoardBatch snapshot = m_soups;
+    int lanes = current.GetLaneWords();
+    int soupCount = current.GetBoardCount();
+    double explosive = static_cast<double>(m_options.explosionDensity) * m_options.boardSize * m_options.boardSize;
+    std::uint64_t soupArea = static_cast<std::uint64_t>(m_options.soupSize) * m_options.soupSize;
+
+    // soups that have not settled yet, the bits past the soup count never run
+    std::vector<std::uint64_t> running(lanes, 0);
+    for (int soup = 0; soup < soupCount; soup++) {
+        running[soup / 64] |= std::uint64_t(1) << (soup % 64);
+    }
+    int remaining = soupCount;
+    std::vector<std::uint64_t> differs(lanes);
+    std::vector<std::uint64_t> alive(lanes);
+    std::vector<std::uint64_t> lastPopulations = current.GetPopulations();
+    int snapshotGeneration = 0;
+
+    int generation = 0;
+    while (remaining > 0 && generation < m_options.maxGenerations) {
+        engine.Step(current, next);
+        std::swap(current, next);
+        generation++;
+
+        // a soup back at the board of the snapshot repeats from there on with that period
+        compareBoards(current, snapshot, differs, alive);
+        for (int w = 0; w < lanes; w++) {
+            std::uint64_t settled = running[w] & (~differs[w] | ~alive[w]);
+            running[w] &= ~settled;
+            remaining -= PopCount(settled);
+            result.soups[static_cast<int>(SweepOutcome::Dies)] += PopCount(settled & ~alive[w]);
+            result.soups[static_cast<int>(SweepOutcome::Stabilizes)] += PopCount(settled & alive[w]);
+            if (settled & alive[w]) {
+                result.period = std::max(result.period, generation - snapshotGeneration);
+            }
+        }
+
+        if (remaining > 0 && generation % m_options.checkInterval == 0) {
+            std::vector<std::uint64_t> populations = current.GetPopulations();
+            int exploded = 0;
+            for (int soup = 0; soup < soupCount; soup++) {
+                bool dense = static_cast<double>(populations[soup]) > explosive;
+                bool growing = populations[soup] > 2 * lastPopulations[soup] && populations[soup] > soupArea;
+                exploded += ((running[soup / 64] >> (soup % 64)) & 1) && (dense || growing);
+            }
+            if (exploded > 0) {
+                result.outcome = SweepOutcome::Explodes;
+                result.generations = generation;
+                result.soups[static_cast<int>(SweepOutcome::Explodes)] = exploded;
+                return result;
+            }
+            lastPopulations = populations;
+        }
+
+        // copies at powers of two catch a cycle within twice its start and period
+        if ((generation & (generation - 1)) == 0) {
+            snapshot = current;
+            snapshotGeneration = generation;
+        }
+    }
+
+    result.generations = generation;
+    if (remaining > 0) {
+        result.soups[static_cast<int>(SweepOutcome::Chaotic)] = remaining;
+        result.outcome = SweepOutcome::Chaotic;
+    } else {
+        result.outcome = result.soups[static_cast<int>(SweepOutcome::Stabilizes)] > 0 ? SweepOutcome::Stabilizes
+                                                                                     : SweepOutcome::Dies;
+    }
+    return result;
+}
@@ -0,0 +1,81 @@
+#ifndef GAME_OF_LIFE_RULE_SWEEP_H
+#define GAME_OF_LIFE_RULE_SWEEP_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "board_batch.h"
+#include "rule.h"
+#include "thread_pool.h"
+
+enum class SweepOutcome {
+    // every soup dies out
+    Dies,
+    // every soup settles into a still life or oscillator, some of them alive
+    Stabilizes,
+    // a soup grows past the explosion threshold, the rule is dropped there
+    Explodes,
+    // some soup is still changing at the last generation
+    Chaotic,
+};
+
+const char* GetSweepOutcomeName(SweepOutcome outcome);
+bool ParseSweepOutcome(const std::string& name, SweepOutcome& outcome);
+
+struct SweepOptions {
+    std::uint64_t seed = 1;
+    // every rule runs the same soups, squares of soupSize in the middle of a bounded board
+    int soupCount = 64;
+    int soupSize = 16;
+    float density = .5f;
+    int boardSize = 64;
+    int maxGenerations = 1000;
+    // populations are checked every checkInterval generations, a soup explodes once its
+    // population is above explosionDensity of the board or more than doubles between two checks
+    // while above the soup's area
+    int checkInterval = 8;
+    float explosionDensity = .25f;
+};
+
+struct SweepResult {
+    Rule rule;
+    SweepOutcome outcome;
+    // generation the outcome was known at
+    int generations;
+    // soups by outcome, soups still running when a soup exploded are not counted
+    std::array<int, 4> soups;
+    // longest period of the stabilized soups
+    int period;
+};
+
+// Runs random soups under many rules, a rule on each thread, and tells what every rule does with
+// them. The soups of a rule are stepped together in a BoardBatch, and every generation each
+// soup is compared word by word with a copy taken at the last power of two generations, which
+// finds any cycle, death included, soon after the soup enters it. A rule is given up on as soon
+// as one of its soups explodes, so the explosive rules that most of rule space is made of cost
+// tens of generations rather than the full run.
+class RuleSweep {
+public:
+    // threads in total, hardware concurrency when 0
+    explicit RuleSweep(const SweepOptions& options, int threadCount = 0);
+
+    // two-state rules of radius 1
+    static bool Supports(const Rule& rule);
+
+    const SweepOptions& GetOptions() const;
+    int GetThreadCount() const;
+
+    // results in the order of the rules
+    std::vector<SweepResult> Run(const std::vector<Rule>& rules);
+    SweepResult RunRule(const Rule& rule) const;
+
+private:
+    SweepOptions m_options;
+    // generation 0 of every rule
+    BoardBatch m_soups;
+    ThreadPool m_pool;
+};
+
+#endif //GAME_OF_LIFE_RULE_SWEEP_H
@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <vector>
+
+#include "temporal_blocking_engine.h"
+#include "bit_kernel.h"
+#include "bits.h"
+#include "../profiling/trace.h"
+
+namespace {
+
+// A tile and its halo in a scratch buffer of two generations: scratch rows are board rows
+// firstRow - halo on, scratch words are board words firstWord - 1 on. Every row has a spare word
+// on either side and the buffer a spare row above and below, all zero, for the kernel to read.
+struct TileScratch {
+    int rows = 0;
+    int words = 0;
+    int stride = 0;
+    std::vector<std::uint64_t> buffers[2];
+
+    // the spare words and rows are never written, only a new shape clears the buffers
+    void Reset(int rowCount, int wordCount) {
+        if (rowCount == rows && wordCount == words) {
+            return;
+        }
+        rows = rowCount;
+        words = wordCount;
+        stride = wordCount + 2;
+        for (std::vector<std::uint64_t>& buffer : buffers) {
+            buffer.assign(static_cast<size_t>(rowCount + 2) * stride, 0);
+        }
+    }
+
+    std::uint64_t* GetRow(int buffer, int row) {
+        return buffers[buffer].data() + static_cast<size_t>(row + 1) * stride + 1;
+    }
+};
+
+// the cells of a halo word beyond the edges of the board, from the cells they stand for
+std::uint64_t wrappedCells(const Board& board, int y, int word, std::uint64_t outside) {
+    int width = board.GetWidth();
+    int height = board.GetHeight();
+    bool mirrored;
+    if (!WrapRow(board.GetTopology(), height, y, mirrored)) {
+        return 0;
+    }
+
+    std::uint64_t cells = 0;
+    for (; outside != 0; outside &= outside - 1) {
+        int bit = CountTrailingZeros(outside);
+        int x = word * 64 + bit - 1;
+        x = ((mirrored ? width - 1 - x : x) % width + width) % width;
+        cells |= static_cast<std::uint64_t>(board.Get(x, y)) << bit;
+    }
+    return cells;
+}
+
+template<typename Kernel>
+void stepTile(const Kernel& nextState, const Board& current, Board& next, int firstRow, int firstWord, int rows,
+              int words, int generations) {
+    int height = current.GetHeight();
+    int wordsPerRow = current.GetWordsPerRow();
+    bool bounded = current.GetTopology() == Topology::Bounded;
+    int halo = generations;
+
+    static thread_local TileScratch tileScratch;
+    TileScratch& scratch = tileScratch;
+    scratch.Reset(rows + 2 * halo, words + 2);
+
+    // cells of the board in every scratch word, none for the words beyond the edges
+    static thread_local std::vector<std::uint64_t> interiorMasks;
+    std::vector<std::uint64_t>& interior = interiorMasks;
+    interior.resize(scratch.words);
+    for (int j = 0; j < scratch.words; j++) {
+        int w = firstWord - 1 + j;
+        interior[j] = w >= 0 && w < wordsPerRow ? current.GetInteriorMask(w) : 0;
+    }
+
+    bool edge = bounded && (firstRow < halo || firstRow + rows + halo > height || firstWord <= 1
+                            || firstWord + words >= wordsPerRow - 1);
+    for (int r = 0; r < scratch.rows; r++) {
+        int y = firstRow - halo + r;
+        bool inside = y >= 0 && y < height;
+        const std::uint64_t* board = inside ? current.GetRow(y) + firstWord - 1 : nullptr;
+        std::uint64_t* row = scratch.GetRow(0, r);
+        for (int j = 0; j < scratch.words; j++) {
+            std::uint64_t word = inside ? board[j] & interior[j] : 0;
+            std::uint64_t outside = inside ? ~interior[j] : ~std::uint64_t(0);
+            if (!bounded && outside != 0) {
+                word |= wrappedCells(current, y, firstWord - 1 + j, outside);
+            }
+            row[j] = word;
+        }
+    }
+
+    // the cells next to the scratch edges miss some of their neighbours, so the rows that are still
+    // right shrink by one at either end every generation and are the only ones stepped; the wrong
+    // cells at either end of the rows stay within the word of halo
+    int source = 0;
+    for (int generation = 1; generation <= generations; generation++) {
+        for (int r = generation; r < scratch.rows - generation; r++) {
+            std::uint64_t* out = scratch.GetRow(1 - source, r);
+            StepRowWords(nextState, scratch.GetRow(source, r - 1), scratch.GetRow(source, r),
+                         scratch.GetRow(source, r + 1), out, scratch.words);
+            if (edge) {
+                // the cells beyond the edges of a bounded board stay dead
+                int y = firstRow - halo + r;
+                for (int j = 0; j < scratch.words; j++) {
+                    out[j] = y >= 0 && y < height ? out[j] & interior[j] : 0;
+                }
+            }
+        }
+        source = 1 - source;
+    }
+
+    for (int r = 0; r < rows; r++) {
+        const std::uint64_t* row = scratch.GetRow(source, halo + r);
+        std::copy(row + 1, row + 1 + words, next.GetRow(firstRow + r) + firstWord);
+    }
+}
+
+}
+
+TemporalBlockingEngine::TemporalBlockingEngine(const Rule& rule, int blockGenerations, int tileRows, int tileWords,
+                                               int threadCount)
+        : Engine(rule),
+          m_blockGenerations(std::max(1, std::min(blockGenerations, MaxBlockGenerations))),
+          m_tileRows(std::max(1, tileRows)),
+          m_tileWords(std::max(1, tileWords)),
+          m_pool(threadCount) {
+}
+
+const char* TemporalBlockingEngine::GetName() const {
+    return "blocked";
+}
+
+void TemporalBlockingEngine::Step(const Board& current, Board& next) {
+    pass(current, next, 1);
+}
+
+void TemporalBlockingEngine::Advance(Board& current, Board& next, int generations) {
+    while (generations > 0) {
+        int count = std::min(generations, m_blockGenerations);
+        pass(current, next, count);
+        std::swap(current, next);
+        generations -= count;
+    }
+}
+
+void TemporalBlockingEngine::pass(const Board& current, Board& next, int generations) {
+    GOL_TRACE_SCOPE("TemporalBlockingEngine::pass");
+    int height = current.GetHeight();
+    int wordsPerRow = current.GetWordsPerRow();
+    if (current.GetWidth() == 0) {
+        next.RefreshHalo();
+        return;
+    }
+    int rowTiles = (height + m_tileRows - 1) / m_tileRows;
+    int columnTiles = (wordsPerRow + m_tileWords - 1) / m_tileWords;
+
+    VisitRuleKernel(m_rule, [&](const auto& kernel) {
+        m_pool.ParallelFor(rowTiles * columnTiles, [&](int begin, int end) {
+            for (int tile = begin; tile < end; tile++) {
+                int firstRow = tile / columnTiles * m_tileRows;
+                int firstWord = tile % columnTiles * m_tileWords;
+                stepTile(kernel, current, next, firstRow, firstWord, std::min(m_tileRows, height - firstRow),
+                         std::min(m_tileWords, wordsPerRow - firstWord), generations);
+            }
+        });
+    });
+
+    next.RefreshHalo();
+}
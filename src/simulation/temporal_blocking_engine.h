@@ -0,0 +1,39 @@
+#ifndef GAME_OF_LIFE_TEMPORAL_BLOCKING_ENGINE_H
+#define GAME_OF_LIFE_TEMPORAL_BLOCKING_ENGINE_H
+
+#include "engine.h"
+#include "thread_pool.h"
+
+// Runs the bitwise kernel over tiles of the board on every core, several generations per pass.
+// A tile is copied with a halo of k rows above and below and a word on either side into a
+// scratch buffer that stays in cache, advanced k generations there while the part of the halo
+// that is still right shrinks by a cell per generation, and written back. The board goes through
+// memory once every k generations rather than every generation, at the cost of stepping the
+// halo, about 2k / tileRows + 2 / tileWords more cells.
+//
+// The cells of the halo beyond the edges of the board are the cells they wrap around to on a
+// torus or a Klein bottle, and are kept dead on a bounded board. Two-state rules only.
+class TemporalBlockingEngine : public Engine {
+public:
+    // the horizontal halo is a word, so a pass is at most 64 generations
+    static constexpr int MaxBlockGenerations = 64;
+
+    // threads in total, hardware concurrency when 0
+    explicit TemporalBlockingEngine(const Rule& rule, int blockGenerations = 8, int tileRows = 256,
+                                    int tileWords = 32, int threadCount = 0);
+
+    const char* GetName() const override;
+    void Step(const Board& current, Board& next) override;
+    void Advance(Board& current, Board& next, int generations) override;
+
+private:
+    // writes the board generations after current into next
+    void pass(const Board& current, Board& next, int generations);
+
+    int m_blockGenerations;
+    int m_tileRows;
+    int m_tileWords;
+    ThreadPool m_pool;
+};
+
+#endif //GAME_OF_LIFE_TEMPORAL_BLOCKING_ENGINE_H
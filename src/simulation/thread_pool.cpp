@@ -0,0 +1,98 @@
+#include <algorithm>
+
+#include "thread_pool.h"
+#include "../profiling/trace.h"
+
+ThreadPool::ThreadPool(int threadCount)
+        : m_body(nullptr), m_count(0), m_chunk(1), m_epoch(0), m_pending(0), m_stop(false), m_next(0) {
+    if (threadCount <= 0) {
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    for (int i = 1; i < threadCount; i++) {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+int ThreadPool::GetThreadCount() const {
+    return static_cast<int>(m_workers.size()) + 1;
+}
+
+void ThreadPool::ParallelFor(int count, const std::function<void(int, int)>& body) {
+    if (count <= 0) {
+        return;
+    }
+    if (m_workers.empty() || count == 1) {
+        body(0, count);
+        return;
+    }
+
+    // a few chunks per thread so that uneven chunks even out
+    int chunk = std::max(1, count / (GetThreadCount() * 4));
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_body = &body;
+        m_count = count;
+        m_chunk = chunk;
+        m_next = 0;
+        m_pending = static_cast<int>(m_workers.size());
+        m_epoch++;
+    }
+    m_wake.notify_all();
+
+    runChunks(body, count, chunk);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_pending == 0; });
+    m_body = nullptr;
+}
+
+void ThreadPool::workerLoop() {
+    GOL_TRACE_THREAD_NAME("worker pool");
+    std::uint64_t seenEpoch = 0;
+    while (true) {
+        const std::function<void(int, int)>* body;
+        int count;
+        int chunk;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this, seenEpoch] { return m_stop || m_epoch != seenEpoch; });
+            if (m_stop) {
+                return;
+            }
+            seenEpoch = m_epoch;
+            body = m_body;
+            count = m_count;
+            chunk = m_chunk;
+        }
+
+        runChunks(*body, count, chunk);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_pending == 0) {
+            m_done.notify_one();
+        }
+    }
+}
+
+void ThreadPool::runChunks(const std::function<void(int, int)>& body, int count, int chunk) {
+    while (true) {
+        int begin = m_next.fetch_add(chunk);
+        if (begin >= count) {
+            return;
+        }
+        // on the track of whichever thread runs the chunk, the caller's included
+        GOL_TRACE_SCOPE("ThreadPool::chunk");
+        body(begin, std::min(count, begin + chunk));
+    }
+}
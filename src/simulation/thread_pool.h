@@ -0,0 +1,47 @@
+#ifndef GAME_OF_LIFE_THREAD_POOL_H
+#define GAME_OF_LIFE_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads that run the iterations of a loop together with the calling thread.
+class ThreadPool {
+public:
+    // threads in total including the caller of ParallelFor, hardware concurrency when 0
+    explicit ThreadPool(int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int GetThreadCount() const;
+
+    // calls body(begin, end) for chunks covering [0, count) and returns once all of them are done;
+    // one loop at a time, body must not call ParallelFor of the same pool
+    void ParallelFor(int count, const std::function<void(int begin, int end)>& body);
+
+private:
+    void workerLoop();
+    void runChunks(const std::function<void(int, int)>& body, int count, int chunk);
+
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    // the current loop, workers pick it up when the epoch changes
+    const std::function<void(int, int)>* m_body;
+    int m_count;
+    int m_chunk;
+    std::uint64_t m_epoch;
+    int m_pending;
+    bool m_stop;
+    std::atomic<int> m_next;
+};
+
+#endif //GAME_OF_LIFE_THREAD_POOL_H
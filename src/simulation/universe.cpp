@@ -0,0 +1,648 @@
+#include <algorithm>
+
+#include "universe.h"
+#include "bits.h"
+#include "../profiling/trace.h"
+
+namespace {
+
+const int chunkSize = Universe::ChunkSize;
+// as Board lays the rows out, with the two ghost cells
+const int chunkWordsPerRow = (chunkSize + 2 + 63) / 64;
+
+std::uint64_t chunkKey(std::int32_t x, std::int32_t y) {
+    return (std::uint64_t(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y);
+}
+
+std::int32_t chunkOf(std::int64_t cell) {
+    return static_cast<std::int32_t>(cell >= 0 ? cell / chunkSize : (cell + 1) / chunkSize - 1);
+}
+
+int cellInChunk(std::int64_t cell) {
+    return static_cast<int>(cell - static_cast<std::int64_t>(chunkOf(cell)) * chunkSize);
+}
+
+// cell x of a row is bit x + 1, -1 and the width are the ghost cells
+bool getBit(const std::uint64_t* row, int x) {
+    int bit = x + 1;
+    return (row[bit / 64] >> (bit % 64)) & 1;
+}
+
+void setBit(std::uint64_t* row, int x, bool value) {
+    int bit = x + 1;
+    std::uint64_t mask = std::uint64_t(1) << (bit % 64);
+    row[bit / 64] = value ? row[bit / 64] | mask : row[bit / 64] & ~mask;
+}
+
+// count cells of source starting at cell sourceX into target from cell targetX, the other bits of
+// target are kept; reads up to the padding word after the row
+void copyCells(const std::uint64_t* source, int sourceX, std::uint64_t* target, int targetX, int count) {
+    int sourceBit = sourceX + 1;
+    int targetBit = targetX + 1;
+    while (count > 0) {
+        int offset = targetBit % 64;
+        int n = std::min(count, 64 - offset);
+        int sourceOffset = sourceBit % 64;
+        const std::uint64_t* word = source + sourceBit / 64;
+        std::uint64_t bits = sourceOffset == 0 ? word[0] : (word[0] >> sourceOffset) | (word[1] << (64 - sourceOffset));
+        std::uint64_t mask = (n == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << n) - 1) << offset;
+        target[targetBit / 64] = (target[targetBit / 64] & ~mask) | ((bits << offset) & mask);
+        sourceBit += n;
+        targetBit += n;
+        count -= n;
+    }
+}
+
+// bits of the cells [first, last] that fall into the word
+std::uint64_t cellMask(int word, int first, int last) {
+    int low = std::max(first + 1, word * 64) - word * 64;
+    int high = std::min(last + 1, word * 64 + 63) - word * 64;
+    if (low > high) {
+        return 0;
+    }
+    std::uint64_t mask = high - low == 63 ? ~std::uint64_t(0) : (std::uint64_t(1) << (high - low + 1)) - 1;
+    return mask << low;
+}
+
+std::uint64_t mix64(std::uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// hash of the cells of a chunk in all of its planes, seeded with the hash of the chunk's key; 0
+// for a chunk without cells so that empty chunks, allocated or not, add nothing to the universe's
+// hash. Every word is mixed with its position on its own, the mixes overlap instead of waiting for
+// each other
+std::uint64_t chunkHash(std::uint64_t key, const Board& board) {
+    std::uint64_t sum = 0;
+    std::uint64_t any = 0;
+    std::uint64_t salt = mix64(key);
+    for (int plane = 0; plane < board.GetPlaneCount(); plane++) {
+        const std::uint64_t* row = board.GetRow(0, plane);
+        size_t stride = board.GetRow(1, plane) - row;
+        for (int y = 0; y < chunkSize; y++, row += stride) {
+            for (int w = 0; w < chunkWordsPerRow; w++) {
+                std::uint64_t word = row[w] & cellMask(w, 0, chunkSize - 1);
+                any |= word;
+                sum += mix64(word ^ salt);
+                salt += 0x9E3779B97F4A7C15ull;
+            }
+        }
+    }
+    return any != 0 ? mix64(sum) : 0;
+}
+
+// sum of the cells of a chunk, equal for equal cells; oscillators are looked for where it repeats
+// and confirmed by comparing the cells themselves
+std::uint64_t fingerprint(const Board& board) {
+    std::uint64_t sum = 0;
+    for (int plane = 0; plane < board.GetPlaneCount(); plane++) {
+        const std::uint64_t* row = board.GetRow(0, plane);
+        size_t stride = board.GetRow(1, plane) - row;
+        for (int y = 0; y < chunkSize; y++, row += stride) {
+            for (int w = 0; w < chunkWordsPerRow; w++) {
+                sum += (row[w] & cellMask(w, 0, chunkSize - 1)) * (2 * plane + 1);
+            }
+        }
+    }
+    return sum;
+}
+
+// true when the ghost cells of the boards, which hold the edges of the neighbouring chunks,
+// are the same
+bool haloEquals(const Board& board, const Board& other) {
+    for (int plane = 0; plane < board.GetPlaneCount(); plane++) {
+        const std::uint64_t* row = board.GetRow(-1, plane);
+        const std::uint64_t* otherRow = other.GetRow(-1, plane);
+        size_t stride = board.GetRow(0, plane) - row;
+        std::uint64_t difference = 0;
+        for (int y = -1; y <= chunkSize; y++, row += stride, otherRow += stride) {
+            bool ghostRow = y < 0 || y == chunkSize;
+            for (int w = 0; w < chunkWordsPerRow; w++) {
+                difference |= (row[w] ^ otherRow[w]) & (ghostRow ? ~std::uint64_t(0) : ~cellMask(w, 0, chunkSize - 1));
+            }
+        }
+        if (difference != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool cellsDiffer(const Board& board, const Board& other) {
+    for (int plane = 0; plane < board.GetPlaneCount(); plane++) {
+        const std::uint64_t* row = board.GetRow(0, plane);
+        const std::uint64_t* otherRow = other.GetRow(0, plane);
+        size_t stride = board.GetRow(1, plane) - row;
+        for (int y = 0; y < chunkSize; y++, row += stride, otherRow += stride) {
+            std::uint64_t difference = 0;
+            for (int w = 0; w < chunkWordsPerRow; w++) {
+                difference |= (row[w] ^ otherRow[w]) & cellMask(w, 0, chunkSize - 1);
+            }
+            if (difference != 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+}
+
+size_t UniverseDelta::GetByteSize() const {
+    size_t bytes = sizeof(*this);
+    for (const auto& chunk : chunks) {
+        bytes += sizeof(chunk) + chunk.second.GetByteSize();
+    }
+    return bytes;
+}
+
+Universe::Universe(std::unique_ptr<Engine> engine)
+        : m_engine(std::move(engine)), m_generation(0),
+          m_planeCount(GetStatePlaneCount(m_engine->GetRule())) {
+}
+
+int Universe::findChunk(std::int32_t x, std::int32_t y) const {
+    return m_map.Find(chunkKey(x, y));
+}
+
+int Universe::addChunk(std::int32_t x, std::int32_t y) {
+    int index;
+    if (m_freeSlots.empty()) {
+        index = static_cast<int>(m_chunks.size());
+        m_chunks.emplace_back();
+    } else {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+
+    Chunk& chunk = m_chunks[index];
+    chunk.x = x;
+    chunk.y = y;
+    chunk.current = Board(chunkSize, chunkSize, m_planeCount);
+    chunk.next = Board(chunkSize, chunkSize, m_planeCount);
+    chunk.hash = 0;
+    chunk.hashStale = false;
+    thaw(chunk);
+    chunk.needed = true;
+    m_map.Insert(chunkKey(x, y), index);
+    m_active.push_back(index);
+    return index;
+}
+
+void Universe::removeChunk(int index) {
+    Chunk& chunk = m_chunks[index];
+    m_map.Erase(chunkKey(chunk.x, chunk.y));
+    chunk.current = Board();
+    chunk.next = Board();
+    chunk.phases.clear();
+    chunk.phases.shrink_to_fit();
+    m_freeSlots.push_back(index);
+}
+
+void Universe::thaw(Chunk& chunk) {
+    chunk.period = 0;
+    chunk.phase = 0;
+    chunk.frozen = false;
+    chunk.fingerprintCount = 0;
+}
+
+void Universe::trackOscillation(Chunk& chunk) {
+    if (chunk.frozen) {
+        return;
+    }
+    if (chunk.period != 0) {
+        if (chunk.phase < chunk.period) {
+            return;
+        }
+        // a whole period has been recorded, the chunk oscillates if it is back where it started
+        if (!cellsDiffer(chunk.current, chunk.phases[0])) {
+            chunk.frozen = true;
+            chunk.phase = 0;
+            return;
+        }
+        thaw(chunk);
+    }
+
+    for (int i = MaxFrozenPeriod; i > 0; i--) {
+        chunk.fingerprints[i] = chunk.fingerprints[i - 1];
+    }
+    chunk.fingerprints[0] = fingerprint(chunk.current);
+    chunk.fingerprintCount = std::min(chunk.fingerprintCount + 1, MaxFrozenPeriod + 1);
+    for (int period = 1; period < chunk.fingerprintCount; period++) {
+        if (chunk.fingerprints[period] == chunk.fingerprints[0]) {
+            // the next period of steps is recorded, with the halo each is stepped with
+            chunk.period = period;
+            chunk.phase = 0;
+            chunk.phases.resize(period);
+            break;
+        }
+    }
+}
+
+void Universe::growAndPrune() {
+    GOL_TRACE_SCOPE("Universe::growAndPrune");
+    int radius = m_engine->GetRule().radius;
+    int wordsPerRow = chunkWordsPerRow;
+    std::uint64_t north[chunkWordsPerRow];
+    std::uint64_t south[chunkWordsPerRow];
+    std::uint64_t all[chunkWordsPerRow];
+
+    for (int index : m_active) {
+        m_chunks[index].needed = false;
+    }
+    std::uint64_t interior[chunkWordsPerRow];
+    for (int w = 0; w < wordsPerRow; w++) {
+        interior[w] = cellMask(w, 0, chunkSize - 1);
+    }
+
+    // live cells within the radius of an edge or a corner reach into the chunk beyond it, the
+    // chunks added here are empty and reach nowhere themselves
+    size_t count = m_active.size();
+    for (size_t i = 0; i < count; i++) {
+        int index = m_active[i];
+        const Board& board = m_chunks[index].current;
+        std::fill(north, north + wordsPerRow, 0);
+        std::fill(south, south + wordsPerRow, 0);
+        std::fill(all, all + wordsPerRow, 0);
+        // dying cells keep their chunk but reach no further
+        std::uint64_t any = 0;
+        for (int y = 0; y < chunkSize; y++) {
+            const std::uint64_t* row = board.GetRow(y);
+            for (int w = 0; w < wordsPerRow; w++) {
+                std::uint64_t word = row[w];
+                std::uint64_t higher = 0;
+                for (int plane = 1; plane < m_planeCount; plane++) {
+                    higher |= board.GetRow(y, plane)[w];
+                }
+                any |= (word | higher) & interior[w];
+                word &= ~higher & interior[w];
+                all[w] |= word;
+                north[w] |= y < radius ? word : 0;
+                south[w] |= y >= chunkSize - radius ? word : 0;
+            }
+        }
+        if (any == 0) {
+            continue;
+        }
+        m_chunks[index].needed = true;
+
+        const std::uint64_t* rows[3] = {north, all, south};
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                int first = dx < 0 ? 0 : dx > 0 ? chunkSize - radius : 0;
+                int last = dx < 0 ? radius - 1 : chunkSize - 1;
+                bool reaches = false;
+                for (int w = 0; w < wordsPerRow && !reaches; w++) {
+                    reaches = (rows[dy + 1][w] & cellMask(w, first, last)) != 0;
+                }
+                if ((dx == 0 && dy == 0) || !reaches) {
+                    continue;
+                }
+
+                std::int32_t x = m_chunks[index].x + dx;
+                std::int32_t y = m_chunks[index].y + dy;
+                int neighbour = findChunk(x, y);
+                if (neighbour < 0) {
+                    addChunk(x, y);
+                } else {
+                    m_chunks[neighbour].needed = true;
+                }
+            }
+        }
+    }
+
+    std::vector<int> active;
+    active.reserve(m_active.size());
+    for (int index : m_active) {
+        if (m_chunks[index].needed) {
+            active.push_back(index);
+        } else {
+            removeChunk(index);
+        }
+    }
+    m_active = std::move(active);
+}
+
+void Universe::exchangeHalo(Chunk& chunk) {
+    const Board* around[3][3];
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            int index = findChunk(chunk.x + dx, chunk.y + dy);
+            around[dy + 1][dx + 1] = index < 0 ? nullptr : &m_chunks[index].current;
+        }
+    }
+
+    Board& board = chunk.current;
+    int wordsPerRow = board.GetWordsPerRow();
+    int last = chunkSize - 1;
+    for (int plane = 0; plane < m_planeCount; plane++) {
+        // the ghost rows are the facing rows of the chunks above and below, their ghost cells
+        // the corners of the diagonal chunks
+        for (int side = 0; side < 3; side += 2) {
+            std::uint64_t* ghost = board.GetRow(side == 0 ? -1 : chunkSize, plane);
+            int facing = side == 0 ? last : 0;
+            const Board* across = around[side][1];
+            for (int w = 0; w < wordsPerRow; w++) {
+                ghost[w] = across != nullptr ? across->GetRow(facing, plane)[w] : 0;
+            }
+            const Board* west = around[side][0];
+            const Board* east = around[side][2];
+            setBit(ghost, -1, west != nullptr && getBit(west->GetRow(facing, plane), last));
+            setBit(ghost, chunkSize, east != nullptr && getBit(east->GetRow(facing, plane), 0));
+        }
+
+        const Board* west = around[1][0];
+        const Board* east = around[1][2];
+        for (int y = 0; y < chunkSize; y++) {
+            std::uint64_t* row = board.GetRow(y, plane);
+            setBit(row, -1, west != nullptr && getBit(west->GetRow(y, plane), last));
+            setBit(row, chunkSize, east != nullptr && getBit(east->GetRow(y, plane), 0));
+        }
+    }
+}
+
+void Universe::stepPadded(Chunk& chunk) {
+    int radius = m_engine->GetRule().radius;
+    int size = chunkSize + 2 * radius;
+    if (m_window.GetWidth() != size || m_window.GetPlaneCount() != m_planeCount) {
+        m_window = Board(size, size, m_planeCount);
+        m_windowNext = Board(size, size, m_planeCount);
+    }
+
+    const Board* around[3][3];
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            int index = findChunk(chunk.x + dx, chunk.y + dy);
+            around[dy + 1][dx + 1] = index < 0 ? nullptr : &m_chunks[index].current;
+        }
+    }
+
+    // window cells [0, R) come from the chunk to the west, [R, R + size) from this one and the
+    // rest from the one to the east
+    const int sourceX[3] = {chunkSize - radius, 0, 0};
+    const int targetX[3] = {0, radius, radius + chunkSize};
+    const int counts[3] = {radius, chunkSize, radius};
+    int wordsPerRow = m_window.GetWordsPerRow();
+    for (int plane = 0; plane < m_planeCount; plane++) {
+        for (int y = 0; y < size; y++) {
+            int chunkY = y - radius;
+            int side = chunkY < 0 ? 0 : chunkY >= chunkSize ? 2 : 1;
+            int sourceY = chunkY - (side - 1) * chunkSize;
+            std::uint64_t* row = m_window.GetRow(y, plane);
+            std::fill(row, row + wordsPerRow, 0);
+            for (int column = 0; column < 3; column++) {
+                const Board* source = around[side][column];
+                if (source != nullptr) {
+                    copyCells(source->GetRow(sourceY, plane), sourceX[column], row, targetX[column], counts[column]);
+                }
+            }
+        }
+    }
+
+    m_engine->Step(m_window, m_windowNext);
+
+    int chunkWordsPerRow = chunk.next.GetWordsPerRow();
+    for (int plane = 0; plane < m_planeCount; plane++) {
+        for (int y = 0; y < chunkSize; y++) {
+            std::uint64_t* row = chunk.next.GetRow(y, plane);
+            std::fill(row, row + chunkWordsPerRow, 0);
+            copyCells(m_windowNext.GetRow(y + radius, plane), radius, row, 0, chunkSize);
+        }
+    }
+}
+
+void Universe::Step() {
+    GOL_TRACE_SCOPE("Universe::Step");
+    growAndPrune();
+
+    bool padded = m_engine->GetRule().radius > 1;
+    for (int index : m_active) {
+        Chunk& chunk = m_chunks[index];
+        // the step only writes the next boards, the neighbours' current ones stay as they were
+        if (padded) {
+            stepPadded(chunk);
+            continue;
+        }
+
+        exchangeHalo(chunk);
+        if (chunk.frozen) {
+            if (haloEquals(chunk.current, chunk.phases[chunk.phase])) {
+                // next holds the generation before, which is already the one after for periods
+                // of one and two
+                chunk.phase = (chunk.phase + 1) % chunk.period;
+                if (chunk.period > 2) {
+                    chunk.next = chunk.phases[chunk.phase];
+                }
+                continue;
+            }
+            // the neighbours changed, the chunk is stepped until it settles again
+            thaw(chunk);
+        } else if (chunk.period != 0) {
+            chunk.phases[chunk.phase++] = chunk.current;
+        }
+        m_engine->Step(chunk.current, chunk.next);
+    }
+
+    for (int index : m_active) {
+        Chunk& chunk = m_chunks[index];
+        std::swap(chunk.current, chunk.next);
+        // settled chunks keep their hash, the others are hashed again when it is asked for
+        chunk.hashStale = chunk.hashStale || cellsDiffer(chunk.current, chunk.next);
+        if (!padded) {
+            trackOscillation(chunk);
+        }
+    }
+    m_generation++;
+}
+
+std::uint64_t Universe::GetGeneration() const {
+    return m_generation;
+}
+
+void Universe::SetGeneration(std::uint64_t generation) {
+    m_generation = generation;
+}
+
+Engine& Universe::GetEngine() const {
+    return *m_engine;
+}
+
+void Universe::SetEngine(std::unique_ptr<Engine> engine) {
+    m_engine = std::move(engine);
+    m_planeCount = GetStatePlaneCount(m_engine->GetRule());
+    for (int index : m_active) {
+        m_chunks[index].current.SetPlaneCount(m_planeCount);
+        m_chunks[index].next.SetPlaneCount(m_planeCount);
+        m_chunks[index].hashStale = true;
+        thaw(m_chunks[index]);
+    }
+}
+
+bool Universe::Get(std::int64_t x, std::int64_t y) const {
+    int index = findChunk(chunkOf(x), chunkOf(y));
+    return index >= 0 && m_chunks[index].current.Get(cellInChunk(x), cellInChunk(y));
+}
+
+int Universe::GetState(std::int64_t x, std::int64_t y) const {
+    int index = findChunk(chunkOf(x), chunkOf(y));
+    return index < 0 ? 0 : m_chunks[index].current.GetState(cellInChunk(x), cellInChunk(y));
+}
+
+void Universe::SetState(std::int64_t x, std::int64_t y, int state) {
+    int index = findChunk(chunkOf(x), chunkOf(y));
+    if (index < 0) {
+        if (state == 0) {
+            return;
+        }
+        index = addChunk(chunkOf(x), chunkOf(y));
+    }
+    m_chunks[index].current.SetState(cellInChunk(x), cellInChunk(y), state);
+    m_chunks[index].hashStale = true;
+    thaw(m_chunks[index]);
+}
+
+void Universe::Clear() {
+    m_map.Clear();
+    m_chunks.clear();
+    m_freeSlots.clear();
+    m_active.clear();
+}
+
+void Universe::Paste(const Board& board, std::int64_t x, std::int64_t y) {
+    for (int j = 0; j < board.GetHeight(); j++) {
+        for (int i = 0; i < board.GetWidth(); i++) {
+            int state = board.GetState(i, j);
+            if (state != 0 || GetState(x + i, y + j) != 0) {
+                SetState(x + i, y + j, state);
+            }
+        }
+    }
+}
+
+Board Universe::Copy(std::int64_t x, std::int64_t y, int width, int height) const {
+    Board board(width, height, m_planeCount);
+    // only the chunks that overlap the rectangle have cells to copy, the rest of it is dead
+    for (int index : m_active) {
+        const Chunk& chunk = m_chunks[index];
+        std::int64_t originX = static_cast<std::int64_t>(chunk.x) * chunkSize;
+        std::int64_t originY = static_cast<std::int64_t>(chunk.y) * chunkSize;
+        std::int64_t left = std::max(x, originX);
+        std::int64_t right = std::min(x + width, originX + chunkSize);
+        std::int64_t top = std::max(y, originY);
+        std::int64_t bottom = std::min(y + height, originY + chunkSize);
+        if (left >= right || top >= bottom) {
+            continue;
+        }
+
+        for (int plane = 0; plane < m_planeCount; plane++) {
+            for (std::int64_t row = top; row < bottom; row++) {
+                const std::uint64_t* source = chunk.current.GetRow(static_cast<int>(row - originY), plane);
+                std::uint64_t* target = board.GetRow(static_cast<int>(row - y), plane);
+                copyCells(source, static_cast<int>(left - originX), target, static_cast<int>(left - x),
+                          static_cast<int>(right - left));
+            }
+        }
+    }
+    return board;
+}
+
+bool Universe::GetBounds(std::int64_t& left, std::int64_t& top, std::int64_t& right, std::int64_t& bottom) const {
+    bool found = false;
+    for (int index : m_active) {
+        const Chunk& chunk = m_chunks[index];
+        const Board& board = chunk.current;
+        int wordsPerRow = board.GetWordsPerRow();
+        std::int64_t originX = static_cast<std::int64_t>(chunk.x) * chunkSize;
+        std::int64_t originY = static_cast<std::int64_t>(chunk.y) * chunkSize;
+        for (int y = 0; y < chunkSize; y++) {
+            for (int w = 0; w < wordsPerRow; w++) {
+                std::uint64_t word = 0;
+                for (int plane = 0; plane < m_planeCount; plane++) {
+                    word |= board.GetRow(y, plane)[w];
+                }
+                word &= board.GetInteriorMask(w);
+                if (word == 0) {
+                    continue;
+                }
+
+                std::int64_t first = originX + w * 64 + CountTrailingZeros(word) - 1;
+                std::int64_t last = originX + w * 64 + 63 - CountLeadingZeros(word) - 1;
+                if (!found) {
+                    left = first;
+                    right = last;
+                    top = originY + y;
+                    bottom = originY + y;
+                    found = true;
+                }
+                left = std::min(left, first);
+                right = std::max(right, last);
+                top = std::min(top, originY + y);
+                bottom = std::max(bottom, originY + y);
+            }
+        }
+    }
+    return found;
+}
+
+std::uint64_t Universe::GetPopulation() const {
+    std::uint64_t population = 0;
+    for (int index : m_active) {
+        population += m_chunks[index].current.GetPopulation();
+    }
+    return population;
+}
+
+size_t Universe::GetChunkCount() const {
+    return m_active.size();
+}
+
+size_t Universe::GetFrozenChunkCount() const {
+    size_t count = 0;
+    for (int index : m_active) {
+        count += m_chunks[index].frozen;
+    }
+    return count;
+}
+
+std::uint64_t Universe::GetHash() const {
+    std::uint64_t hash = 0;
+    for (int index : m_active) {
+        const Chunk& chunk = m_chunks[index];
+        if (chunk.hashStale) {
+            chunk.hash = chunkHash(chunkKey(chunk.x, chunk.y), chunk.current);
+            chunk.hashStale = false;
+        }
+        hash ^= chunk.hash;
+    }
+    return hash;
+}
+
+UniverseDelta Universe::GetLastDelta() const {
+    UniverseDelta delta;
+    for (int index : m_active) {
+        const Chunk& chunk = m_chunks[index];
+        BoardDelta chunkDelta = BoardDelta::Between(chunk.next, chunk.current);
+        if (!chunkDelta.IsEmpty()) {
+            delta.chunks.emplace_back(chunkKey(chunk.x, chunk.y), std::move(chunkDelta));
+        }
+    }
+    return delta;
+}
+
+void Universe::Rewind(const UniverseDelta& delta) {
+    // chunks that died out since have been freed, they come back empty
+    for (const auto& chunkDelta : delta.chunks) {
+        auto x = static_cast<std::int32_t>(chunkDelta.first >> 32);
+        auto y = static_cast<std::int32_t>(chunkDelta.first & 0xFFFFFFFF);
+        int index = findChunk(x, y);
+        if (index < 0) {
+            index = addChunk(x, y);
+        }
+        chunkDelta.second.ApplyTo(m_chunks[index].current);
+        m_chunks[index].hashStale = true;
+        thaw(m_chunks[index]);
+    }
+    m_generation--;
+}
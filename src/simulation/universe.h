@@ -0,0 +1,140 @@
+#ifndef GAME_OF_LIFE_UNIVERSE_H
+#define GAME_OF_LIFE_UNIVERSE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "board.h"
+#include "board_delta.h"
+#include "chunk_map.h"
+#include "engine.h"
+
+// The changes of every chunk a step touched, as XOR deltas keyed like the chunks.
+struct UniverseDelta {
+    std::vector<std::pair<std::uint64_t, BoardDelta>> chunks;
+
+    size_t GetByteSize() const;
+};
+
+// Unbounded plane of cells made of square chunks, each a Board of its own, found through a hash
+// map keyed by the chunk coordinates. Chunks are allocated when live cells come within the rule's
+// radius of their edge and freed once they are empty with no live cells nearby, so memory grows
+// with the area that is alive rather than with the bounding box.
+//
+// Radius 1 rules step every chunk in place: the halo of its board is filled from the edges of its
+// eight neighbours first, the engines read the halo like any other cell. Larger-than-Life rules
+// step a copy of the chunk padded with radius cells of its neighbours.
+//
+// Settled radius 1 chunks are frozen: once the cells of a chunk repeat with a period of up to
+// MaxFrozenPeriod generations, the generations of one period are kept together with the halo each
+// was stepped with. While the neighbours give the same halo again the chunk is not stepped, its
+// next generation is the next one kept, so still lifes and blinkers in the ash cost a compare of
+// the halo per step.
+class Universe {
+public:
+    // 254 cells and the two ghost cells fill four words per row exactly
+    static const int ChunkSize = 254;
+    static const int MaxFrozenPeriod = 3;
+
+    explicit Universe(std::unique_ptr<Engine> engine);
+
+    Universe(const Universe&) = delete;
+    Universe& operator=(const Universe&) = delete;
+
+    void Step();
+    std::uint64_t GetGeneration() const;
+    void SetGeneration(std::uint64_t generation);
+
+    Engine& GetEngine() const;
+    // adds or drops state planes of every chunk when the new rule has a different state count
+    void SetEngine(std::unique_ptr<Engine> engine);
+
+    bool Get(std::int64_t x, std::int64_t y) const;
+    int GetState(std::int64_t x, std::int64_t y) const;
+    void SetState(std::int64_t x, std::int64_t y, int state);
+
+    void Clear();
+    // copies the board with its cell (0, 0) at x, y
+    void Paste(const Board& board, std::int64_t x, std::int64_t y);
+    // the cells of the rectangle, with the state planes of the rule
+    Board Copy(std::int64_t x, std::int64_t y, int width, int height) const;
+    // smallest rectangle around the cells that are not dead, false when there are none
+    bool GetBounds(std::int64_t& left, std::int64_t& top, std::int64_t& right, std::int64_t& bottom) const;
+
+    std::uint64_t GetPopulation() const;
+    size_t GetChunkCount() const;
+    size_t GetFrozenChunkCount() const;
+    // 64-bit hash of the states and positions of all cells, the same for the same plane however
+    // its chunks happen to be allocated; only the chunks that changed since the last call are
+    // hashed again
+    std::uint64_t GetHash() const;
+
+    // calls visit(chunkX, chunkY, board) for every chunk, cell (0, 0) of the board is cell
+    // (chunkX * ChunkSize, chunkY * ChunkSize) of the plane
+    template<typename Visitor>
+    void ForEachChunk(Visitor&& visit) const {
+        for (int index : m_active) {
+            const Chunk& chunk = m_chunks[index];
+            visit(chunk.x, chunk.y, chunk.current);
+        }
+    }
+
+    // what the last Step changed, only valid until the universe is changed again
+    UniverseDelta GetLastDelta() const;
+    // undoes the last step with its delta
+    void Rewind(const UniverseDelta& delta);
+
+private:
+    struct Chunk {
+        std::int32_t x;
+        std::int32_t y;
+        Board current;
+        // the previous generation after a step, scratch otherwise
+        Board next;
+        // hash of current, computed on demand once the cells have changed
+        mutable std::uint64_t hash;
+        mutable bool hashStale;
+        bool needed;
+
+        // of the oscillation being recorded or replayed, 0 for none
+        int period;
+        // generations recorded so far while recording, the one current is once frozen
+        int phase;
+        bool frozen;
+        // the generations of one period, each with the halo it was stepped with
+        std::vector<Board> phases;
+        // of the cells of the last generations, the newest first
+        std::uint64_t fingerprints[MaxFrozenPeriod + 1];
+        int fingerprintCount;
+    };
+
+    int findChunk(std::int32_t x, std::int32_t y) const;
+    int addChunk(std::int32_t x, std::int32_t y);
+    void removeChunk(int index);
+    void thaw(Chunk& chunk);
+    // after a step, looks for a period in the chunk and freezes it once one has been recorded
+    void trackOscillation(Chunk& chunk);
+
+    void growAndPrune();
+    void exchangeHalo(Chunk& chunk);
+    void stepPadded(Chunk& chunk);
+
+    std::unique_ptr<Engine> m_engine;
+    std::uint64_t m_generation;
+    int m_planeCount;
+
+    ChunkMap m_map;
+    // slots of freed chunks are reused, their boards are released
+    std::vector<Chunk> m_chunks;
+    std::vector<int> m_freeSlots;
+    std::vector<int> m_active;
+
+    // chunk with the radius of its neighbours around it, for rules wider than the halo
+    Board m_window;
+    Board m_windowNext;
+};
+
+#endif //GAME_OF_LIFE_UNIVERSE_H
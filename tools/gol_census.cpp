@@ -0,0 +1,124 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "simulation/census.h"
+#include "simulation/rle.h"
+
+// Soup census: runs random soups until they settle on every core and counts the objects they
+// leave behind by canonical code, the most common first.
+
+namespace {
+
+struct Options {
+    long long soups = 10000;
+    long long first = 0;
+    int threads = 0;
+    // runs only this soup and prints it with its objects
+    long long onlySoup = -1;
+    // most common objects printed, all when 0
+    int top = 0;
+    CensusOptions census;
+};
+
+void printUsage() {
+    std::cerr << "usage: gol_census [--soups N] [--first N] [--seed S] [--threads N] [--rule B3/S23]\n"
+                 "                  [--engine NAME] [--soup-size N] [--board-size N] [--max-generations N]\n"
+                 "                  [--top N] [--soup N]\n"
+                 "Runs random soups until they settle and counts their objects by apgcode.\n"
+                 "--soup N prints soup N as RLE with the objects it leaves." << std::endl;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (argument == "--soups" && hasValue) {
+            options.soups = std::atoll(argv[++i]);
+        } else if (argument == "--first" && hasValue) {
+            options.first = std::atoll(argv[++i]);
+        } else if (argument == "--seed" && hasValue) {
+            options.census.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (argument == "--threads" && hasValue) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (argument == "--rule" && hasValue) {
+            if (!ParseRule(argv[++i], options.census.rule)) {
+                std::cerr << "Invalid rule " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (argument == "--engine" && hasValue) {
+            options.census.engine = argv[++i];
+        } else if (argument == "--soup-size" && hasValue) {
+            options.census.soupSize = std::atoi(argv[++i]);
+        } else if (argument == "--board-size" && hasValue) {
+            options.census.boardSize = std::atoi(argv[++i]);
+        } else if (argument == "--max-generations" && hasValue) {
+            options.census.maxGenerations = std::atoi(argv[++i]);
+        } else if (argument == "--top" && hasValue) {
+            options.top = std::atoi(argv[++i]);
+        } else if (argument == "--soup" && hasValue) {
+            options.onlySoup = std::atoll(argv[++i]);
+        } else {
+            printUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+int printSoup(const Census& census, long long index) {
+    std::cout << WriteRle(census.MakeSoup(index), FormatRule(census.GetOptions().rule));
+    SoupResult result = census.RunSoup(index);
+    if (!result.stabilized) {
+        std::cout << "soup " << index << " did not stabilize within " << census.GetOptions().maxGenerations
+                  << " generations" << std::endl;
+        return 1;
+    }
+
+    std::cout << "soup " << index << " stabilized at generation " << result.generations << " with period "
+              << result.period << std::endl;
+    for (const std::string& code : result.objects) {
+        std::cout << code << std::endl;
+    }
+    return 0;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+    if (!Census::Supports(options.census)) {
+        std::cerr << "The census runs two-state rules of radius 1 on soups smaller than the board, "
+                  << options.census.engine << " cannot run " << FormatRule(options.census.rule) << std::endl;
+        return 1;
+    }
+
+    Census census(options.census, options.threads);
+    if (options.onlySoup >= 0) {
+        return printSoup(census, options.onlySoup);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    census.Run(options.first, options.soups);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    auto counts = census.GetTally().GetCounts();
+    std::uint64_t objects = 0;
+    for (const auto& entry : counts) {
+        objects += entry.second;
+    }
+    std::cout << "# " << census.GetSoupCount() << " soups of " << FormatRule(options.census.rule) << " from "
+              << options.first << ", seed " << options.census.seed << ", " << census.GetThreadCount()
+              << " threads, " << seconds << " s, " << census.GetSoupCount() / seconds << " soups/s\n"
+              << "# " << census.GetUnstabilizedCount() << " did not stabilize, " << objects << " objects of "
+              << counts.size() << " kinds" << std::endl;
+    for (size_t i = 0; i < counts.size() && (options.top == 0 || i < static_cast<size_t>(options.top)); i++) {
+        std::cout << counts[i].second << ' ' << counts[i].first << '\n';
+    }
+    return 0;
+}
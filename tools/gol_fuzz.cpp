@@ -0,0 +1,780 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "simulation/batch_engine.h"
+#include "simulation/dataflow_engine.h"
+#include "simulation/engine_registry.h"
+#include "simulation/journal.h"
+#include "simulation/lenia_engine.h"
+#include "simulation/pipelined_engine.h"
+#include "simulation/rle.h"
+#include "simulation/temporal_blocking_engine.h"
+#include "simulation/universe.h"
+
+// Differential fuzzer: random boards are stepped by every engine and by the reference engine,
+// the first disagreement is shrunk to a small single step repro and printed as RLE.
+
+namespace {
+
+struct Options {
+    int cases = 1000;
+    std::uint64_t seed = 1;
+    // runs only this case, for reproducing a failure
+    long long onlyCase = -1;
+    std::vector<std::string> engines;
+    // every case uses this rule instead of a random one when set
+    bool fixedRule = false;
+    Rule rule = ConwayRule;
+    // every case uses this topology instead of a random one when set
+    bool fixedTopology = false;
+    Topology topology = Topology::Bounded;
+    // checks the Lenia engine against a direct convolution instead
+    bool lenia = false;
+    // checks seeking in a journal of the case against the reference engine's generations instead
+    bool journal = false;
+    // checks a universe of chunks with the case pasted into it against a large bounded board instead
+    bool universe = false;
+};
+
+struct FuzzCase {
+    int width;
+    int height;
+    float density;
+    std::uint64_t boardSeed;
+    int generations;
+    Rule rule;
+    Topology topology;
+};
+
+void printUsage() {
+    std::cerr << "usage: gol_fuzz [--cases N] [--seed S] [--case N] [--engine NAME]... [--rule B3/S23]\n"
+                 "                [--topology bounded|torus|klein] [--lenia] [--journal] [--universe]\n"
+                 "Cross-checks every engine against the reference engine on random boards and rules,\n"
+                 "the batch engine with the case board among random ones in a transposed batch.\n"
+                 "--lenia cross-checks the FFT convolution of the Lenia engine against a direct one.\n"
+                 "--journal records every case in a journal and seeks it back in random order.\n"
+                 "--universe steps every case in a universe of chunks beside a bounded board, with rewinds." << std::endl;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (argument == "--cases" && hasValue) {
+            options.cases = std::atoi(argv[++i]);
+        } else if (argument == "--seed" && hasValue) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (argument == "--case" && hasValue) {
+            options.onlyCase = std::atoll(argv[++i]);
+        } else if (argument == "--engine" && hasValue) {
+            options.engines.emplace_back(argv[++i]);
+        } else if (argument == "--rule" && hasValue) {
+            if (!ParseRule(argv[++i], options.rule)) {
+                std::cerr << "Invalid rule " << argv[i] << std::endl;
+                return false;
+            }
+            options.fixedRule = true;
+        } else if (argument == "--topology" && hasValue) {
+            if (!ParseTopology(argv[++i], options.topology)) {
+                std::cerr << "Invalid topology " << argv[i] << std::endl;
+                return false;
+            }
+            options.fixedTopology = true;
+        } else if (argument == "--lenia") {
+            options.lenia = true;
+        } else if (argument == "--journal") {
+            options.journal = true;
+        } else if (argument == "--universe") {
+            options.universe = true;
+        } else {
+            printUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+// sizes around word and tile boundaries are where bit-packed kernels go wrong
+int randomExtent(std::mt19937_64& random) {
+    const int interesting[] = {1, 2, 3, 62, 63, 64, 65, 66, 126, 127, 128, 129, 130, 191, 192, 193};
+    if (random() % 2 == 0) {
+        return interesting[random() % (sizeof(interesting) / sizeof(interesting[0]))];
+    }
+    return 1 + static_cast<int>(random() % 200);
+}
+
+// counts with random Hensel letters, "B2-a3ce/S12k", to cover the parser along with the engines
+std::string randomHenselRule(std::mt19937_64& random) {
+    const char* letters[9] = {"", "ce", "ceaikn", "ceaiknjqry", "ceaiknjqrytwz", "ceaiknjqry", "ceaikn", "ce", ""};
+    std::string rule;
+    for (const char* half : {"B", "/S"}) {
+        rule += half;
+        for (int count = 0; count <= 8; count++) {
+            if (random() % 2 == 0) {
+                continue;
+            }
+
+            rule += static_cast<char>('0' + count);
+            std::string chosen;
+            for (const char* letter = letters[count]; *letter != '\0'; letter++) {
+                if (random() % 3 == 0) {
+                    chosen += *letter;
+                }
+            }
+            if (!chosen.empty() && random() % 2 == 0) {
+                rule += (random() % 2 == 0 ? "-" : "") + chosen;
+            }
+        }
+    }
+    return rule;
+}
+
+// ranges around the counts a box of the radius can reach, written out and parsed back to cover
+// the parser
+Rule randomLargerThanLifeRule(std::mt19937_64& random) {
+    Rule rule{0, 0};
+    rule.radius = 2 + static_cast<int>(random() % 5);
+    rule.countsCentre = random() % 2 == 0;
+    rule.states = random() % 2 == 0 ? 2 : 3 + static_cast<int>(random() % 6);
+    int boxCells = (2 * rule.radius + 1) * (2 * rule.radius + 1);
+    for (RuleRange* range : {&rule.birthRange, &rule.survivalRange}) {
+        int first = static_cast<int>(random() % static_cast<std::uint64_t>(boxCells / 2));
+        int last = first + static_cast<int>(random() % static_cast<std::uint64_t>(boxCells / 2));
+        *range = RuleRange{static_cast<std::uint16_t>(first), static_cast<std::uint16_t>(last)};
+    }
+
+    Rule parsed;
+    if (!ParseRule(FormatRule(rule), parsed) || parsed != rule) {
+        std::cerr << "ParseRule did not read back " << FormatRule(rule) << std::endl;
+        std::exit(1);
+    }
+    return parsed;
+}
+
+FuzzCase makeCase(std::uint64_t seed, long long index) {
+    std::mt19937_64 random(seed * 0x9E3779B97F4A7C15ull + static_cast<std::uint64_t>(index));
+    FuzzCase fuzzCase{};
+    fuzzCase.width = randomExtent(random);
+    fuzzCase.height = randomExtent(random);
+    fuzzCase.density = static_cast<float>(random() % 101) / 100.f;
+    fuzzCase.boardSeed = random();
+    fuzzCase.generations = 1 + static_cast<int>(random() % 64);
+    fuzzCase.topology = static_cast<Topology>(random() % 3);
+
+    // the cases are split evenly between the rules with specialized kernels, any
+    // outer-totalistic rule, isotropic non-totalistic rules, Generations and Larger-than-Life
+    const Rule specialized[] = {ConwayRule, HighLifeRule, SeedsRule, DayAndNightRule};
+    switch (random() % 5) {
+        case 0:
+            fuzzCase.rule = specialized[random() % (sizeof(specialized) / sizeof(specialized[0]))];
+            break;
+        case 1:
+            fuzzCase.rule = Rule{static_cast<std::uint16_t>(random() % 512), static_cast<std::uint16_t>(random() % 512)};
+            break;
+        case 2:
+            if (!ParseRule(randomHenselRule(random), fuzzCase.rule)) {
+                std::cerr << "ParseRule rejected a generated rule" << std::endl;
+                std::exit(1);
+            }
+            break;
+        case 3:
+            fuzzCase.rule = randomLargerThanLifeRule(random);
+            // the reference engine counts every box cell by cell
+            fuzzCase.generations = 1 + fuzzCase.generations % 8;
+            break;
+        default:
+            // state counts just past a power of two need one more plane than the one before
+            fuzzCase.rule = Rule{static_cast<std::uint16_t>(random() % 512), static_cast<std::uint16_t>(random() % 512)};
+            fuzzCase.rule.states = random() % 2 == 0 ? 3 + static_cast<int>(random() % 6)
+                                                      : 2 + static_cast<int>(random() % (MaxRuleStates - 1));
+            break;
+    }
+    return fuzzCase;
+}
+
+// live cells from the density, and under Generations rules random dying states in the dead cells
+Board makeInitialBoard(const FuzzCase& fuzzCase) {
+    Board board(fuzzCase.width, fuzzCase.height, GetStatePlaneCount(fuzzCase.rule));
+    board.Randomize(fuzzCase.boardSeed, fuzzCase.density);
+    if (fuzzCase.rule.states > 2) {
+        std::mt19937_64 random(fuzzCase.boardSeed);
+        for (int y = 0; y < board.GetHeight(); y++) {
+            for (int x = 0; x < board.GetWidth(); x++) {
+                int state = static_cast<int>(random() % static_cast<std::uint64_t>(fuzzCase.rule.states));
+                if (!board.Get(x, y) && state >= 2) {
+                    board.SetState(x, y, state);
+                }
+            }
+        }
+    }
+    board.SetTopology(fuzzCase.topology);
+    board.RefreshHalo();
+    return board;
+}
+
+Board step(Engine& engine, const Board& board) {
+    Board next(board.GetWidth(), board.GetHeight(), board.GetPlaneCount());
+    next.SetTopology(board.GetTopology());
+    engine.Step(board, next);
+    return next;
+}
+
+// the cell a ghost cell stands for, worked out with plain modular arithmetic rather than WrapRow
+// so that the halo is checked independently of the engines, which all rely on it
+int expectedGhostState(const Board& board, int x, int y) {
+    int width = board.GetWidth();
+    int height = board.GetHeight();
+    if (board.GetTopology() == Topology::Bounded) {
+        return 0;
+    }
+    if (board.GetTopology() == Topology::KleinBottle && (y < 0 || y >= height)) {
+        x = width - 1 - x;
+    }
+    return board.GetState((x + width) % width, (y + height) % height);
+}
+
+// true when every ghost cell of the board matches its topology
+bool haloMatches(const Board& board) {
+    for (int y = -1; y <= board.GetHeight(); y++) {
+        bool ghostRow = y < 0 || y == board.GetHeight();
+        for (int x = -1; x <= board.GetWidth(); x++) {
+            bool ghost = ghostRow || x < 0 || x == board.GetWidth();
+            if (ghost && board.GetState(x, y) != expectedGhostState(board, x, y)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool mismatches(const std::string& engineName, const Rule& rule, const Board& board) {
+    auto reference = CreateEngine("reference", rule);
+    auto engine = CreateEngine(engineName, rule);
+    return step(*reference, board) != step(*engine, board);
+}
+
+Board crop(const Board& board, int left, int top, int width, int height) {
+    Board result(width, height, board.GetPlaneCount());
+    result.SetTopology(board.GetTopology());
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            result.SetState(x, y, board.GetState(left + x, top + y));
+        }
+    }
+    result.RefreshHalo();
+    return result;
+}
+
+// greedily drops edge rows and columns, then live and dying cells, while the engine still disagrees
+Board minimize(const std::string& engineName, const Rule& rule, Board board) {
+    bool shrunk = true;
+    while (shrunk) {
+        shrunk = false;
+        const int crops[4][4] = {{1, 0, -1, 0}, {0, 1, 0, -1}, {0, 0, -1, 0}, {0, 0, 0, -1}};
+        for (const auto& c : crops) {
+            int width = board.GetWidth() + c[2];
+            int height = board.GetHeight() + c[3];
+            if (width < 1 || height < 1) {
+                continue;
+            }
+
+            Board candidate = crop(board, c[0], c[1], width, height);
+            if (mismatches(engineName, rule, candidate)) {
+                board = candidate;
+                shrunk = true;
+            }
+        }
+    }
+
+    for (int y = 0; y < board.GetHeight(); y++) {
+        for (int x = 0; x < board.GetWidth(); x++) {
+            int state = board.GetState(x, y);
+            if (state != 0) {
+                board.SetState(x, y, 0);
+                board.RefreshHalo();
+                if (!mismatches(engineName, rule, board)) {
+                    board.SetState(x, y, state);
+                    board.RefreshHalo();
+                }
+            }
+        }
+    }
+    return board;
+}
+
+void report(const std::string& engineName, long long index, const FuzzCase& fuzzCase, int generation,
+            const Board& input) {
+    std::cout << "MISMATCH engine = " << engineName << ", case = " << index
+              << ", board = " << fuzzCase.width << "x" << fuzzCase.height
+              << ", rule = " << FormatRule(fuzzCase.rule)
+              << ", topology = " << GetTopologyName(fuzzCase.topology)
+              << ", generation = " << generation << std::endl;
+
+    Board repro = minimize(engineName, fuzzCase.rule, input);
+    auto reference = CreateEngine("reference", fuzzCase.rule);
+    auto engine = CreateEngine(engineName, fuzzCase.rule);
+    std::string rule = FormatRule(fuzzCase.rule);
+    std::cout << "repro, one step:\n" << WriteRle(repro, rule)
+              << "expected:\n" << WriteRle(step(*reference, repro), rule)
+              << "actual:\n" << WriteRle(step(*engine, repro), rule) << std::endl;
+}
+
+// boards in the batch the case board is stepped with, not a multiple of 64 so that the last word
+// of every cell is partly unused
+const int batchBoardCount = 100;
+
+// true when the batch engine agrees with the reference on the case board, which is put into a
+// batch of random boards at a slot that depends on the case
+bool runBatchCase(long long index, const FuzzCase& fuzzCase, const Board& initial,
+                  const std::vector<Board>& expected) {
+    BoardBatch current(fuzzCase.width, fuzzCase.height, batchBoardCount);
+    current.Randomize(fuzzCase.boardSeed ^ 0x5DEECE66Dull, fuzzCase.density);
+    int slot = static_cast<int>(static_cast<unsigned long long>(index) % batchBoardCount);
+    current.SetBoard(slot, initial);
+    current.SetTopology(fuzzCase.topology);
+    current.RefreshHalo();
+    BoardBatch next(fuzzCase.width, fuzzCase.height, batchBoardCount);
+    next.SetTopology(fuzzCase.topology);
+
+    BatchEngine engine(fuzzCase.rule);
+    for (int generation = 1; generation <= fuzzCase.generations; generation++) {
+        engine.Step(current, next);
+        std::swap(current, next);
+        if (current.GetBoard(slot) != expected[generation]) {
+            std::string rule = FormatRule(fuzzCase.rule);
+            std::cout << "MISMATCH engine = batch, case = " << index
+                      << ", board = " << fuzzCase.width << "x" << fuzzCase.height
+                      << ", rule = " << rule
+                      << ", topology = " << GetTopologyName(fuzzCase.topology)
+                      << ", slot = " << slot
+                      << ", generation = " << generation << std::endl;
+            std::cout << "input:\n" << WriteRle(expected[generation - 1], rule)
+                      << "expected:\n" << WriteRle(expected[generation], rule)
+                      << "actual:\n" << WriteRle(current.GetBoard(slot), rule) << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// true when advancing the engine over every generation of the case in one call lands on the
+// reference's last board, for the engines that step several generations per pass
+bool advanceMatches(Engine& engine, const std::string& label, long long index, const FuzzCase& fuzzCase,
+                    const Board& initial, const Board& expected) {
+    Board current = initial;
+    Board next(current.GetWidth(), current.GetHeight(), current.GetPlaneCount());
+    next.SetTopology(current.GetTopology());
+    engine.Advance(current, next, fuzzCase.generations);
+    if (current == expected && haloMatches(current)) {
+        return true;
+    }
+
+    std::string rule = FormatRule(fuzzCase.rule);
+    std::cout << "MISMATCH engine = " << label << ", case = " << index
+              << ", board = " << fuzzCase.width << "x" << fuzzCase.height
+              << ", rule = " << rule
+              << ", topology = " << GetTopologyName(fuzzCase.topology)
+              << ", generations = " << fuzzCase.generations << std::endl;
+    std::cout << "input:\n" << WriteRle(initial, rule)
+              << "expected:\n" << WriteRle(expected, rule)
+              << "actual:\n" << WriteRle(current, rule) << std::endl;
+    return false;
+}
+
+// true when every engine agrees with the reference on every generation of the case
+bool runCase(const std::vector<std::string>& engines, bool batch, long long index, const FuzzCase& fuzzCase) {
+    Board initial = makeInitialBoard(fuzzCase);
+
+    auto reference = CreateEngine("reference", fuzzCase.rule);
+    std::vector<Board> expected{initial};
+    for (int generation = 0; generation < fuzzCase.generations; generation++) {
+        expected.push_back(step(*reference, expected.back()));
+    }
+    if (!haloMatches(initial)) {
+        std::cout << "MISMATCH halo, case = " << index << ", board = " << fuzzCase.width << "x" << fuzzCase.height
+                  << ", topology = " << GetTopologyName(fuzzCase.topology) << std::endl;
+        return false;
+    }
+
+    bool passed = true;
+    for (const auto& engineName : engines) {
+        auto engine = CreateEngine(engineName, fuzzCase.rule);
+        if (!engine) {
+            // the engine does not run Generations rules
+            continue;
+        }
+
+        Board current = initial;
+        bool stepped = true;
+        for (int generation = 1; generation <= fuzzCase.generations && stepped; generation++) {
+            current = step(*engine, current);
+            if (current != expected[generation] || !haloMatches(current)) {
+                report(engineName, index, fuzzCase, generation, expected[generation - 1]);
+                stepped = false;
+            }
+        }
+        if (!stepped || !advanceMatches(*engine, engineName + " advance", index, fuzzCase, initial, expected.back())) {
+            passed = false;
+        }
+    }
+
+    // tiles of a word and a few rows put most cells of the small boards next to a tile edge, with
+    // passes of up to 7 generations
+    bool blocked = std::find(engines.begin(), engines.end(), "blocked") != engines.end();
+    if (blocked && CreateEngine("blocked", fuzzCase.rule)) {
+        TemporalBlockingEngine tiles(fuzzCase.rule, 1 + static_cast<int>(index % 7), 3 + static_cast<int>(index % 5), 1, 2);
+        if (!advanceMatches(tiles, "blocked small tiles", index, fuzzCase, initial, expected.back())) {
+            passed = false;
+        }
+    }
+
+    // bands of a few rows and more threads than the sandboxes have cores keep the stages of a
+    // pass close behind each other
+    bool pipelined = std::find(engines.begin(), engines.end(), "pipelined") != engines.end();
+    if (pipelined && CreateEngine("pipelined", fuzzCase.rule)) {
+        PipelinedEngine wavefront(fuzzCase.rule, 1 + static_cast<int>(index % 3), 3);
+        if (!advanceMatches(wavefront, "pipelined small bands", index, fuzzCase, initial, expected.back())) {
+            passed = false;
+        }
+    }
+
+    // tiles of a word and a couple of rows put the small boards over many tiles stepped out of step
+    bool dataflow = std::find(engines.begin(), engines.end(), "dataflow") != engines.end();
+    if (dataflow && CreateEngine("dataflow", fuzzCase.rule)) {
+        DataflowEngine tiles(fuzzCase.rule, 1 + static_cast<int>(index % 4), 1, 3);
+        if (!advanceMatches(tiles, "dataflow small tiles", index, fuzzCase, initial, expected.back())) {
+            passed = false;
+        }
+    }
+
+    if (batch && BatchEngine::Supports(fuzzCase.rule) && !runBatchCase(index, fuzzCase, initial, expected)) {
+        passed = false;
+    }
+    return passed;
+}
+
+// true when seeking a journal of the case, keyframes every few generations, restores every
+// generation of the reference engine in random order, so that the seeks run both ways from the
+// last one as well as from keyframes
+bool runJournalCase(long long index, const FuzzCase& fuzzCase) {
+    Board initial = makeInitialBoard(fuzzCase);
+    auto reference = CreateEngine("reference", fuzzCase.rule);
+    std::vector<Board> expected{initial};
+    for (int generation = 0; generation < fuzzCase.generations; generation++) {
+        expected.push_back(step(*reference, expected.back()));
+    }
+
+    std::string path = (std::filesystem::temp_directory_path() / "gol_fuzz_journal.golj").string();
+    auto keyframeInterval = static_cast<std::uint64_t>(index % 9);
+    {
+        JournalWriter writer(path, initial, keyframeInterval);
+        bool recorded = writer.IsOpen();
+        for (size_t generation = 0; generation < expected.size() && recorded; generation++) {
+            recorded = writer.Record(expected[generation == 0 ? 0 : generation - 1], expected[generation], generation);
+        }
+        if (!recorded) {
+            std::cout << "MISMATCH journal, case = " << index << ": failed to record" << std::endl;
+            std::remove(path.c_str());
+            return false;
+        }
+    }
+
+    std::mt19937_64 random(static_cast<std::uint64_t>(index));
+    std::vector<int> order(expected.size());
+    for (size_t generation = 0; generation < order.size(); generation++) {
+        order[generation] = static_cast<int>(generation);
+    }
+    std::shuffle(order.begin(), order.end(), random);
+
+    JournalReader reader(path);
+    bool passed = reader.IsOpen() && reader.GetLastGeneration() == expected.size() - 1;
+    Board board;
+    for (int generation : order) {
+        if (!passed) {
+            break;
+        }
+        if (!reader.Seek(static_cast<std::uint64_t>(generation), board) || board != expected[generation]
+            || !haloMatches(board)) {
+            std::string rule = FormatRule(fuzzCase.rule);
+            std::cout << "MISMATCH journal, case = " << index << ", board = " << fuzzCase.width << "x"
+                      << fuzzCase.height << ", rule = " << rule
+                      << ", topology = " << GetTopologyName(fuzzCase.topology)
+                      << ", keyframe interval = " << keyframeInterval << ", generation = " << generation << std::endl;
+            std::cout << "expected:\n" << WriteRle(expected[generation], rule)
+                      << "actual:\n" << WriteRle(board, rule) << std::endl;
+            passed = false;
+        }
+    }
+    std::remove(path.c_str());
+    return passed;
+}
+
+// generations a universe case keeps for rewinding
+const int universeRewindDepth = 8;
+
+// the rule without births among dead cells only, a plane of dead cells without edges cannot hold
+// those
+Rule withoutBirthsFromNothing(Rule rule) {
+    if (rule.radius > 1) {
+        rule.birthRange.first = std::max<std::uint16_t>(rule.birthRange.first, 1);
+    } else if (rule.nonTotalistic) {
+        rule.table[0] &= ~std::uint64_t(1);
+    } else {
+        rule.birth &= static_cast<std::uint16_t>(~1u);
+    }
+    return rule;
+}
+
+// true when a universe with the case pasted across a chunk corner, at negative coordinates as often
+// as not, steps like a bounded board with room enough that no cell reaches its edge. Every few
+// generations the universe's hash is compared with that of one rebuilt from the board, and a few
+// steps are rewound and stepped again. froze is set when any chunk was frozen on the way.
+bool runUniverseCase(long long index, const FuzzCase& fuzzCase, bool& froze) {
+    FuzzCase planeCase = fuzzCase;
+    planeCase.rule = withoutBirthsFromNothing(fuzzCase.rule);
+    planeCase.topology = Topology::Bounded;
+    const Rule& rule = planeCase.rule;
+    const char* engineName = rule.radius > 1 ? "ltl" : "bitwise";
+    // radius 1 cases run longer, so that the ash settles and its chunks freeze
+    int generations = rule.radius > 1 ? fuzzCase.generations : 4 * fuzzCase.generations;
+    // no cell moves further than the radius in a generation
+    int margin = generations * rule.radius + 1;
+
+    Board initial = makeInitialBoard(planeCase);
+    Board board(initial.GetWidth() + 2 * margin, initial.GetHeight() + 2 * margin, initial.GetPlaneCount());
+    for (int y = 0; y < initial.GetHeight(); y++) {
+        for (int x = 0; x < initial.GetWidth(); x++) {
+            board.SetState(margin + x, margin + y, initial.GetState(x, y));
+        }
+    }
+    board.RefreshHalo();
+
+    // cell (0, 0) of the board in the plane
+    std::mt19937_64 random(static_cast<std::uint64_t>(index));
+    std::int64_t cornerX = (static_cast<std::int64_t>(random() % 3) - 1) * Universe::ChunkSize;
+    std::int64_t cornerY = (static_cast<std::int64_t>(random() % 3) - 1) * Universe::ChunkSize;
+    std::int64_t originX = cornerX - margin - initial.GetWidth() / 2 + static_cast<std::int64_t>(random() % 9) - 4;
+    std::int64_t originY = cornerY - margin - initial.GetHeight() / 2 + static_cast<std::int64_t>(random() % 9) - 4;
+
+    auto engine = CreateEngine(engineName, rule);
+    Universe universe{CreateEngine(engineName, rule)};
+    universe.Paste(board, originX, originY);
+
+    auto matches = [&](const Board& expected) {
+        std::int64_t left, top, right, bottom;
+        bool inside = !universe.GetBounds(left, top, right, bottom)
+                      || (left >= originX && top >= originY && right < originX + expected.GetWidth()
+                          && bottom < originY + expected.GetHeight());
+        return inside && universe.GetPopulation() == expected.GetPopulation()
+               && universe.Copy(originX, originY, expected.GetWidth(), expected.GetHeight()) == expected;
+    };
+
+    // the last generations with the deltas between them, for the rewinds
+    std::vector<Board> boards{board};
+    std::vector<std::uint64_t> hashes{universe.GetHash()};
+    std::vector<UniverseDelta> deltas;
+    std::string failure = matches(board) ? "" : "paste";
+    froze = false;
+    for (int generation = 1; generation <= generations && failure.empty(); generation++) {
+        board = step(*engine, board);
+        universe.Step();
+        froze = froze || universe.GetFrozenChunkCount() > 0;
+        if (!matches(board)) {
+            failure = "step";
+            break;
+        }
+        boards.push_back(board);
+        hashes.push_back(universe.GetHash());
+        deltas.push_back(universe.GetLastDelta());
+        if (deltas.size() > universeRewindDepth) {
+            boards.erase(boards.begin());
+            hashes.erase(hashes.begin());
+            deltas.erase(deltas.begin());
+        }
+
+        if (generation % 8 == 0) {
+            Universe rebuilt{CreateEngine(engineName, rule)};
+            rebuilt.Paste(board, originX, originY);
+            if (rebuilt.GetHash() != universe.GetHash()) {
+                failure = "hash of a universe rebuilt from the board";
+            }
+        }
+
+        if (failure.empty() && generation % 16 == 0) {
+            int steps = 1 + static_cast<int>(random() % deltas.size());
+            for (int i = 1; i <= steps && failure.empty(); i++) {
+                universe.Rewind(deltas[deltas.size() - i]);
+                size_t back = boards.size() - 1 - i;
+                if (universe.GetGeneration() != static_cast<std::uint64_t>(generation - i) || !matches(boards[back])
+                    || universe.GetHash() != hashes[back]) {
+                    failure = "rewind of " + std::to_string(i) + " steps";
+                }
+            }
+            for (int i = steps - 1; i >= 0 && failure.empty(); i--) {
+                universe.Step();
+                deltas[deltas.size() - 1 - i] = universe.GetLastDelta();
+                size_t back = boards.size() - 1 - i;
+                if (!matches(boards[back]) || universe.GetHash() != hashes[back]) {
+                    failure = "step after a rewind of " + std::to_string(steps) + " steps";
+                }
+            }
+        }
+    }
+
+    if (failure.empty()) {
+        return true;
+    }
+    std::cout << "MISMATCH universe, case = " << index << ", board = " << fuzzCase.width << "x" << fuzzCase.height
+              << ", rule = " << FormatRule(rule) << ", origin = " << originX << ", " << originY
+              << ", generation = " << universe.GetGeneration() << ": " << failure << std::endl;
+    return false;
+}
+
+// the FFT works in float, the growth is steep around the mean, so a potential off by 1e-6 may
+// move a cell by more than that
+const float leniaTolerance = 1e-4f;
+
+// one Lenia step summing every kernel cell, the cells beyond the edges count as 0
+ContinuousBoard stepLeniaDirectly(const LeniaRule& rule, const ContinuousBoard& board) {
+    std::vector<float> kernel = MakeLeniaKernel(rule);
+    int size = 2 * rule.radius + 1;
+    ContinuousBoard next(board.GetWidth(), board.GetHeight());
+    for (int y = 0; y < board.GetHeight(); y++) {
+        for (int x = 0; x < board.GetWidth(); x++) {
+            double potential = 0;
+            for (int dy = -rule.radius; dy <= rule.radius; dy++) {
+                for (int dx = -rule.radius; dx <= rule.radius; dx++) {
+                    int cx = x + dx;
+                    int cy = y + dy;
+                    if (cx >= 0 && cx < board.GetWidth() && cy >= 0 && cy < board.GetHeight()) {
+                        potential += kernel[static_cast<size_t>(dy + rule.radius) * size + dx + rule.radius]
+                                     * board.Get(cx, cy);
+                    }
+                }
+            }
+            double distance = potential - rule.growthMean;
+            double growth = 2 * std::exp(-distance * distance / (2.0 * rule.growthWidth * rule.growthWidth)) - 1;
+            next.Set(x, y, static_cast<float>(std::min(1.0, std::max(0.0, board.Get(x, y) + rule.timeStep * growth))));
+        }
+    }
+    return next;
+}
+
+// true when the engine stays within the tolerance of the direct convolution on every generation
+bool runLeniaCase(std::uint64_t seed, long long index) {
+    std::mt19937_64 random(seed * 0x9E3779B97F4A7C15ull + static_cast<std::uint64_t>(index));
+    // sizes up to 90 with radii up to 13 pad to 4 to 128 cells
+    int width = 1 + static_cast<int>(random() % 90);
+    int height = 1 + static_cast<int>(random() % 90);
+    LeniaRule rule;
+    rule.radius = 1 + static_cast<int>(random() % 13);
+    rule.growthMean = .1f + static_cast<float>(random() % 100) / 500.f;
+    rule.growthWidth = .01f + static_cast<float>(random() % 100) / 2000.f;
+    rule.timeStep = .1f + static_cast<float>(random() % 10) / 20.f;
+    int generations = 1 + static_cast<int>(random() % 4);
+
+    ContinuousBoard expected(width, height);
+    expected.Randomize(random(), static_cast<float>(random() % 101) / 100.f);
+    ContinuousBoard actual = expected;
+    ContinuousBoard next(width, height);
+    LeniaEngine engine(rule, 1);
+    for (int generation = 1; generation <= generations; generation++) {
+        engine.Step(actual, next);
+        std::swap(actual, next);
+        // the next generation starts from the engine's board so the errors do not compound
+        expected = stepLeniaDirectly(rule, expected);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                if (std::fabs(actual.Get(x, y) - expected.Get(x, y)) > leniaTolerance) {
+                    std::cout << "MISMATCH engine = lenia, case = " << index << ", board = " << width << "x" << height
+                              << ", rule = " << FormatLeniaRule(rule) << ", generation = " << generation
+                              << ", cell = (" << x << ", " << y << "), expected " << expected.Get(x, y)
+                              << ", actual " << actual.Get(x, y) << std::endl;
+                    return false;
+                }
+            }
+        }
+        expected = actual;
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    std::vector<std::string> engines;
+    for (const auto& name : GetEngineNames()) {
+        bool selected = options.engines.empty()
+                        || std::find(options.engines.begin(), options.engines.end(), name) != options.engines.end();
+        if (name != "reference" && selected) {
+            engines.push_back(name);
+        }
+    }
+    // the batch engine steps transposed batches of boards, it is not in the registry
+    bool batch = options.engines.empty()
+                 || std::find(options.engines.begin(), options.engines.end(), "batch") != options.engines.end();
+
+    long long first = options.onlyCase >= 0 ? options.onlyCase : 0;
+    long long last = options.onlyCase >= 0 ? options.onlyCase + 1 : options.cases;
+    int failures = 0;
+    int frozenCases = 0;
+    if (options.lenia) {
+        for (long long index = first; index < last; index++) {
+            if (!runLeniaCase(options.seed, index)) {
+                failures++;
+            }
+        }
+        std::cout << (last - first) << " Lenia cases, " << failures << " failed" << std::endl;
+        return failures == 0 ? 0 : 1;
+    }
+
+    for (long long index = first; index < last; index++) {
+        FuzzCase fuzzCase = makeCase(options.seed, index);
+        if (options.fixedRule) {
+            fuzzCase.rule = options.rule;
+        }
+        if (options.fixedTopology) {
+            fuzzCase.topology = options.topology;
+        }
+        bool passed;
+        if (options.universe) {
+            bool froze;
+            passed = runUniverseCase(index, fuzzCase, froze);
+            frozenCases += froze;
+        } else if (options.journal) {
+            passed = runJournalCase(index, fuzzCase);
+        } else {
+            passed = runCase(engines, batch, index, fuzzCase);
+        }
+        if (!passed) {
+            failures++;
+        }
+    }
+    if (options.universe) {
+        std::cout << (last - first) << " universe cases, " << frozenCases << " with frozen chunks, " << failures
+                  << " failed" << std::endl;
+        return failures == 0 ? 0 : 1;
+    }
+    if (options.journal) {
+        std::cout << (last - first) << " journal cases, " << failures << " failed" << std::endl;
+        return failures == 0 ? 0 : 1;
+    }
+
+    std::cout << (last - first) << " cases, " << engines.size() + batch << " engines, " << failures << " failed"
+              << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "simulation/rule_sweep.h"
+
+// Rule-space sweep: runs the same random soups under a list or a range of outer-totalistic rules
+// on every core and prints what each rule does with them.
+
+namespace {
+
+// outer-totalistic rules are numbered by birth in the low 9 bits and survival in the high ones
+constexpr int TotalisticRuleCount = 1 << 18;
+
+struct Options {
+    std::vector<Rule> rules;
+    int threads = 0;
+    // prints only the rules with this outcome when set
+    bool filtered = false;
+    SweepOutcome outcome = SweepOutcome::Stabilizes;
+    SweepOptions sweep;
+};
+
+void printUsage() {
+    std::cerr << "usage: gol_sweep [--rule B3/S23]... [--range FIRST LAST] [--all] [--seed S] [--soups N]\n"
+                 "                 [--generations N] [--board-size N] [--threads N]\n"
+                 "                 [--outcome dies|stabilizes|explodes|chaotic]\n"
+                 "Runs the same soups under every rule and prints whether they die, stabilize, explode\n"
+                 "or stay chaotic. --range runs the outer-totalistic rules numbered FIRST to LAST - 1,\n"
+                 "birth in the low 9 bits and survival in the high 9, --all is every one of the 262144." << std::endl;
+}
+
+// rules first to last - 1
+void addRange(int first, int last, std::vector<Rule>& rules) {
+    for (int index = std::max(0, first); index < std::min(last, TotalisticRuleCount); index++) {
+        rules.push_back(Rule{static_cast<std::uint16_t>(index & 0x1ff), static_cast<std::uint16_t>(index >> 9)});
+    }
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (argument == "--rule" && hasValue) {
+            Rule rule;
+            if (!ParseRule(argv[++i], rule) || !RuleSweep::Supports(rule)) {
+                std::cerr << "Invalid rule " << argv[i] << ", sweeps run two-state rules of radius 1" << std::endl;
+                return false;
+            }
+            options.rules.push_back(rule);
+        } else if (argument == "--range" && i + 2 < argc) {
+            int first = std::atoi(argv[++i]);
+            addRange(first, std::atoi(argv[++i]), options.rules);
+        } else if (argument == "--all") {
+            addRange(0, TotalisticRuleCount, options.rules);
+        } else if (argument == "--seed" && hasValue) {
+            options.sweep.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (argument == "--soups" && hasValue) {
+            options.sweep.soupCount = std::atoi(argv[++i]);
+        } else if (argument == "--generations" && hasValue) {
+            options.sweep.maxGenerations = std::atoi(argv[++i]);
+        } else if (argument == "--board-size" && hasValue) {
+            options.sweep.boardSize = std::atoi(argv[++i]);
+        } else if (argument == "--threads" && hasValue) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (argument == "--outcome" && hasValue) {
+            if (!ParseSweepOutcome(argv[++i], options.outcome)) {
+                std::cerr << "Invalid outcome " << argv[i] << std::endl;
+                return false;
+            }
+            options.filtered = true;
+        } else {
+            printUsage();
+            return false;
+        }
+    }
+    if (options.rules.empty() || options.sweep.soupCount <= 0
+        || options.sweep.boardSize < options.sweep.soupSize) {
+        printUsage();
+        return false;
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    RuleSweep sweep(options.sweep, options.threads);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<SweepResult> results = sweep.Run(options.rules);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int outcomes[4] = {};
+    long long generations = 0;
+    for (const SweepResult& result : results) {
+        outcomes[static_cast<int>(result.outcome)]++;
+        generations += result.generations;
+    }
+    std::cout << "# " << results.size() << " rules, " << options.sweep.soupCount << " soups each, seed "
+              << options.sweep.seed << ", " << sweep.GetThreadCount() << " threads, " << seconds << " s, "
+              << results.size() / seconds << " rules/s, " << static_cast<double>(generations) / results.size()
+              << " generations per rule\n# ";
+    for (int i = 0; i < 4; i++) {
+        std::cout << (i > 0 ? ", " : "") << outcomes[i] << ' ' << GetSweepOutcomeName(static_cast<SweepOutcome>(i));
+    }
+    std::cout << "\n# rule outcome generation dies stabilizes explodes chaotic period" << std::endl;
+
+    for (const SweepResult& result : results) {
+        if (options.filtered && result.outcome != options.outcome) {
+            continue;
+        }
+        std::cout << FormatRule(result.rule) << ' ' << GetSweepOutcomeName(result.outcome) << ' '
+                  << result.generations;
+        for (int count : result.soups) {
+            std::cout << ' ' << count;
+        }
+        std::cout << ' ' << result.period << '\n';
+    }
+    return 0;
+}